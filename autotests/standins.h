@@ -0,0 +1,154 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "zonecore.h"
+
+namespace KWin
+{
+
+/**
+ * Plays the part of a window and its xx_zone_item_v1 resource, counting
+ * the events that would reach the client.
+ */
+class StandInItem : public ZoneCoreItem
+{
+public:
+    explicit StandInItem(ZonesMetrics *metrics = nullptr, const QString &client = QString())
+        : ZoneCoreItem(metrics, client)
+    {
+    }
+
+    QRectF frameGeometry() const override
+    {
+        return geometry;
+    }
+    QMargins frameMargins() const override
+    {
+        return margins;
+    }
+    void move(const QPoint &position) override
+    {
+        geometry.moveTopLeft(position);
+        ++moves;
+    }
+    void sendFrameExtents(const QMargins &margins) override
+    {
+        Q_UNUSED(margins)
+        ++extentsEvents;
+        eventsWhileInert += isInert();
+    }
+    void sendPosition(const QPoint &position) override
+    {
+        lastPosition = position;
+        ++positionEvents;
+        eventsWhileInert += isInert();
+    }
+    void sendPositionFailed() override
+    {
+        ++positionFailedEvents;
+        eventsWhileInert += isInert();
+    }
+    void sendClosed() override
+    {
+        ++closedEvents;
+    }
+
+    QRectF geometry = QRectF(0, 0, 400, 300);
+    QMargins margins = QMargins(4, 24, 4, 4);
+    QPoint lastPosition;
+    int moves = 0;
+    int extentsEvents = 0;
+    int positionEvents = 0;
+    int positionFailedEvents = 0;
+    int closedEvents = 0;
+    int eventsWhileInert = 0;
+};
+
+/// A window, which is destroyed after it closes while its item may live on
+struct StandInWindow
+{
+    QRectF geometry = QRectF(0, 0, 400, 300);
+    QMargins margins = QMargins(4, 24, 4, 4);
+};
+
+/**
+ * Follows a window the way ExtZoneItemV1Interface does, through a pointer
+ * it drops once the window closes.
+ */
+class StandInWindowItem : public StandInItem
+{
+public:
+    StandInWindowItem(ZonesMetrics *metrics, StandInWindow *window)
+        : StandInItem(metrics)
+        , m_window(window)
+    {
+    }
+
+    StandInWindow *window() const
+    {
+        return m_window;
+    }
+
+    bool hasWindow() const override
+    {
+        return m_window;
+    }
+    QRectF frameGeometry() const override
+    {
+        return m_window ? m_window->geometry : QRectF();
+    }
+    QMargins frameMargins() const override
+    {
+        return m_window ? m_window->margins : QMargins();
+    }
+    void move(const QPoint &position) override
+    {
+        if (m_window) {
+            m_window->geometry.moveTopLeft(position);
+            ++moves;
+        }
+    }
+
+protected:
+    void releaseWindow() override
+    {
+        m_window = nullptr;
+    }
+
+private:
+    StandInWindow *m_window;
+};
+
+/// Plays the part of a zone and its xx_zone_v1 resources
+class StandInZone : public ZoneCore
+{
+public:
+    using ZoneCore::ZoneCore;
+
+    int entered = 0;
+    int left = 0;
+    int resized = 0;
+
+protected:
+    void itemEntered(ZoneCoreItem *item) override
+    {
+        Q_UNUSED(item)
+        ++entered;
+    }
+    void itemLeft(ZoneCoreItem *item) override
+    {
+        Q_UNUSED(item)
+        ++left;
+    }
+    void areaResized() override
+    {
+        ++resized;
+    }
+};
+
+} // namespace KWin
@@ -0,0 +1,504 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <QFile>
+#include <unistd.h>
+#endif
+
+#include "standins.h"
+#include "zonesmetrics.h"
+
+using namespace KWin;
+
+static const QStringList s_outputNames = {
+    QStringLiteral("DP-1"),
+    QStringLiteral("DP-2"),
+    QStringLiteral("DP-3"),
+    QStringLiteral("DP-4"),
+    QStringLiteral("HDMI-A-1"),
+    QStringLiteral("HDMI-A-2"),
+};
+
+class ZoneLifecycleTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testInertItem();
+    void testZoneRemovedWithItems();
+    void testForeignRemove();
+    void testMoveBetweenZones();
+    void testSetPositionIsRelative();
+    void testSetPartitions();
+    void testRegistry();
+    void testBatch();
+    void testRandomLifecycles();
+
+private:
+    std::unique_ptr<ZonesMetrics> m_metrics;
+};
+
+// resident set size in bytes, 0 where unknown
+static qint64 residentSetSize()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+
+void ZoneLifecycleTest::initTestCase()
+{
+    // not connected, the metrics are only used for their live object counts
+    m_metrics = std::make_unique<ZonesMetrics>(QDBusConnection(QStringLiteral("kwinzones-no-bus")));
+}
+
+void ZoneLifecycleTest::cleanupTestCase()
+{
+    QCOMPARE(m_metrics->itemsAlive, 0);
+    QCOMPARE(m_metrics->zonesAlive, 0);
+    m_metrics.reset();
+}
+
+void ZoneLifecycleTest::testInertItem()
+{
+    StandInZone zone({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(zone.addItem(&item));
+    QCOMPARE(zone.entered, 1);
+    QCOMPARE(zone.refreshItems(), 2);
+    QCOMPARE(item.extentsEvents, 1);
+    QCOMPARE(item.positionEvents, 1);
+
+    zone.requestPosition(&item, QPoint(100, 100));
+    item.makeInert();
+    QVERIFY(item.isInert());
+    QVERIFY(!item.zone());
+    QCOMPARE(zone.left, 1);
+    QVERIFY(zone.items().isEmpty());
+
+    // inert items do not join zones again and stay silent
+    QVERIFY(!zone.addItem(&item));
+    QCOMPARE(zone.refreshItems(), 0);
+    QCOMPARE(item.moves, 0);
+    QCOMPARE(item.eventsWhileInert, 0);
+}
+
+void ZoneLifecycleTest::testZoneRemovedWithItems()
+{
+    auto zone = std::make_unique<StandInZone>(QList<QRect>{QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(zone->addItem(&item));
+    zone->requestPosition(&item, QPoint(10, 10));
+    zone->markDirty(&item);
+    QCOMPARE(m_metrics->zonesAlive, 1);
+
+    // like an output being unplugged
+    zone.reset();
+    QCOMPARE(m_metrics->zonesAlive, 0);
+    QVERIFY(!item.zone());
+    QVERIFY(!item.isInert());
+
+    StandInZone other({QRect(0, 0, 1280, 720)}, QStringLiteral("DP-2"), m_metrics.get());
+    QVERIFY(other.addItem(&item));
+    QVERIFY(!other.applyPendingPosition(&item));
+}
+
+void ZoneLifecycleTest::testForeignRemove()
+{
+    StandInZone a({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get());
+    StandInZone b({QRect(1920, 0, 1920, 1080)}, QStringLiteral("DP-2"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(a.addItem(&item));
+
+    QVERIFY(!b.removeItem(&item));
+    QCOMPARE(item.zone(), &a);
+    QCOMPARE(a.left, 0);
+    QCOMPARE(b.left, 0);
+}
+
+void ZoneLifecycleTest::testMoveBetweenZones()
+{
+    StandInZone a({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get());
+    StandInZone b({QRect(1920, 0, 1920, 1080)}, QStringLiteral("DP-2"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(a.addItem(&item));
+    QVERIFY(!a.addItem(&item));
+    QVERIFY(b.addItem(&item));
+    QCOMPARE(a.refreshItems(), 0);
+    QCOMPARE(b.refreshItems(), 2);
+
+    QCOMPARE(item.zone(), &b);
+    QCOMPARE(a.left, 1);
+    QVERIFY(a.items().isEmpty());
+    QCOMPARE(b.items().size(), qsizetype(1));
+    QCOMPARE(item.lastPosition, QPoint(-1920, 0));
+}
+
+void ZoneLifecycleTest::testSetPositionIsRelative()
+{
+    StandInZone zone({QRect(1920, 0, 1920, 1080)}, QStringLiteral("DP-2"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(zone.addItem(&item));
+
+    zone.requestPosition(&item, QPoint(30, 40));
+    // a later request replaces the one waiting for the commit
+    zone.requestPosition(&item, QPoint(10, 20));
+    QVERIFY(zone.hasPendingPosition(&item));
+    QCOMPARE(item.moves, 0);
+    QVERIFY(zone.applyPendingPosition(&item));
+    QVERIFY(!zone.hasPendingPosition(&item));
+    QCOMPARE(item.geometry.topLeft(), QPointF(1930, 20));
+    // the events of joining the zone and of the move go out together
+    QCOMPARE(zone.refreshItems(), 2);
+    QCOMPARE(item.positionEvents, 1);
+    QCOMPARE(item.lastPosition, QPoint(10, 20));
+
+    // the position is confirmed even when the item did not move
+    zone.requestPosition(&item, QPoint(10, 20));
+    QVERIFY(zone.applyPendingPosition(&item));
+    QCOMPARE(zone.refreshItems(), 1);
+    QVERIFY(!zone.applyPendingPosition(&item));
+}
+
+void ZoneLifecycleTest::testSetPartitions()
+{
+    StandInZone zone({QRect(0, 0, 1920, 1080), QRect()}, QStringLiteral("composite"), m_metrics.get());
+    StandInItem item(m_metrics.get());
+    QVERIFY(zone.addItem(&item));
+    QCOMPARE(zone.refreshItems(), 2);
+
+    // a configuration change replaces all partitions with a single update
+    zone.setPartitions({QRect(-1280, 0, 1280, 720), QRect(0, 0, 1920, 1080), QRect(1920, 0, 1920, 1080)});
+    QCOMPARE(zone.resized, 1);
+    QCOMPARE(zone.area(), QRect(-1280, 0, 5120, 1080));
+    QCOMPARE(zone.refreshItems(), 1);
+    QCOMPARE(item.lastPosition, QPoint(1280, 0));
+
+    zone.setPartition(2, QRect());
+    QCOMPARE(zone.resized, 2);
+    QCOMPARE(zone.area(), QRect(-1280, 0, 3200, 1080));
+    QCOMPARE(zone.refreshItems(), 0);
+}
+
+/**
+ * The registry is what the compositor keeps: toplevels going away take their
+ * item with them, items going away on their own are forgotten, and output
+ * removal deletes zones that still have items.
+ */
+void ZoneLifecycleTest::testRegistry()
+{
+    auto registry = std::make_unique<ZoneRegistry>();
+    registry->addZone(new StandInZone({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get()));
+    ZoneCore *zone = registry->zone(QStringLiteral("DP-1"));
+    QVERIFY(zone);
+
+    QObject toplevel;
+    StandInWindow window;
+    auto item = new StandInWindowItem(m_metrics.get(), &window);
+    QVERIFY(registry->addItem(&toplevel, item));
+    QCOMPARE(registry->item(&toplevel), item);
+    QVERIFY(zone->addItem(item));
+
+    // one item per toplevel
+    StandInWindowItem second(m_metrics.get(), &window);
+    QVERIFY(!registry->addItem(&toplevel, &second));
+    QCOMPARE(registry->item(&toplevel), item);
+
+    // the client destroys the item
+    delete item;
+    QVERIFY(!registry->item(&toplevel));
+    QVERIFY(zone->items().isEmpty());
+
+    // the window closes and then its toplevel goes away
+    item = new StandInWindowItem(m_metrics.get(), &window);
+    QVERIFY(registry->addItem(&toplevel, item));
+    QVERIFY(zone->addItem(item));
+    QVERIFY(item->setPosition(QPoint(10, 10)));
+    item->closeWindow();
+    QVERIFY(!item->window());
+    QVERIFY(!item->zone());
+    QCOMPARE(item->closedEvents, 1);
+    QVERIFY(item->setPosition(QPoint(20, 20)));
+    QCOMPARE(registry->refreshZones(), 0);
+    registry->removeToplevel(&toplevel);
+    QVERIFY(!registry->item(&toplevel));
+    QCOMPARE(m_metrics->itemsAlive, 1);
+
+    // the output goes away with an item in its zone
+    item = new StandInWindowItem(m_metrics.get(), &window);
+    QVERIFY(registry->addItem(&toplevel, item));
+    QVERIFY(zone->addItem(item));
+    registry->removeZone(QStringLiteral("DP-1"));
+    QVERIFY(!registry->zone(QStringLiteral("DP-1")));
+    QVERIFY(!item->zone());
+    QCOMPARE(m_metrics->zonesAlive, 0);
+
+    registry->addZone(new StandInZone({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-2"), m_metrics.get()));
+    QVERIFY(registry->zone(QStringLiteral("DP-2"))->addItem(item));
+    registry.reset();
+    QCOMPARE(m_metrics->itemsAlive, 1);
+    QCOMPARE(m_metrics->zonesAlive, 0);
+}
+
+/**
+ * A batch applies its requests in order on commit and drops those whose item
+ * or zone went away before.
+ */
+void ZoneLifecycleTest::testBatch()
+{
+    ZoneRegistry registry;
+    registry.addZone(new StandInZone({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get()));
+    registry.addZone(new StandInZone({QRect(1920, 0, 1920, 1080)}, QStringLiteral("DP-2"), m_metrics.get()));
+    auto zone = static_cast<StandInZone *>(registry.zone(QStringLiteral("DP-1")));
+    auto unplugged = registry.zone(QStringLiteral("DP-2"));
+
+    QObject toplevels[4];
+    StandInWindow windows[4];
+    StandInWindowItem *items[4];
+    for (int i = 0; i < 4; ++i) {
+        items[i] = new StandInWindowItem(m_metrics.get(), &windows[i]);
+        QVERIFY(registry.addItem(&toplevels[i], items[i]));
+    }
+
+    ZoneBatch batch;
+    for (int i = 0; i < 3; ++i) {
+        batch.addItem(zone, items[i]);
+        batch.setPosition(items[i], QPoint(i * 100, 50));
+    }
+    batch.addItem(unplugged, items[3]);
+    // not in a zone when it is applied, so it fails
+    batch.setPosition(items[3], QPoint(10, 10));
+    QCOMPARE(batch.size(), qsizetype(8));
+
+    // the client destroys an item and an output goes away before the commit
+    delete items[2];
+    registry.removeZone(QStringLiteral("DP-2"));
+
+    QCOMPARE(batch.commit(registry), 5);
+    QCOMPARE(batch.size(), qsizetype(0));
+    QCOMPARE(zone->entered, 2);
+    QVERIFY(zone->hasPendingPosition(items[1]));
+    QVERIFY(!items[3]->zone());
+    QCOMPARE(items[3]->positionFailedEvents, 1);
+
+    // the moves wait for the commits of the surfaces
+    QVERIFY(zone->applyPendingPosition(items[0]));
+    QVERIFY(zone->applyPendingPosition(items[1]));
+    QCOMPARE(registry.refreshZones(), 4);
+    QCOMPARE(items[1]->lastPosition, QPoint(100, 50));
+
+    // an empty batch does nothing
+    QCOMPARE(batch.commit(registry), 0);
+}
+
+/**
+ * Runs random sequences of what clients and the compositor do to zones and
+ * items through a ZoneRegistry, checking after every step that the
+ * bookkeeping is consistent and that nothing is kept alive. Windows are
+ * destroyed right after they close, as in KWin, so build with
+ * -DECM_ENABLE_SANITIZERS=address to catch items that still reach them.
+ *
+ * KWINZONES_TEST_SEED and KWINZONES_TEST_ITERATIONS override the defaults.
+ */
+void ZoneLifecycleTest::testRandomLifecycles()
+{
+    bool ok = false;
+    quint32 seed = qEnvironmentVariableIntValue("KWINZONES_TEST_SEED", &ok);
+    if (!ok) {
+        seed = 26;
+    }
+    int iterations = qEnvironmentVariableIntValue("KWINZONES_TEST_ITERATIONS", &ok);
+    if (!ok) {
+        iterations = 50000;
+    }
+    qDebug() << "seed" << seed << "iterations" << iterations;
+    QRandomGenerator random(seed);
+
+    // an xdg_toplevel and its window, which closes before the toplevel goes
+    struct Toplevel {
+        std::unique_ptr<QObject> toplevel = std::make_unique<QObject>();
+        std::unique_ptr<StandInWindow> window = std::make_unique<StandInWindow>();
+    };
+    std::vector<Toplevel> toplevels;
+    auto registry = std::make_unique<ZoneRegistry>();
+    qint64 warmRss = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        if (i == iterations / 10) {
+            warmRss = residentSetSize();
+        }
+
+        enum Operation {
+            MapWindow,
+            DestroyToplevel,
+            CreateItem,
+            DestroyItem,
+            AddItem,
+            RemoveItem,
+            SetPosition,
+            Commit,
+            CloseWindow,
+            PlugOutput,
+            UnplugOutput,
+            ChangeOutput,
+            ChangeWindow,
+            Refresh,
+            OperationCount,
+        };
+        const auto operation = Operation(random.bounded(int(OperationCount)));
+        const int index = toplevels.empty() ? -1 : random.bounded(int(toplevels.size()));
+        Toplevel *toplevel = index < 0 ? nullptr : &toplevels[index];
+        auto item = toplevel ? static_cast<StandInWindowItem *>(registry->item(toplevel->toplevel.get())) : nullptr;
+        const QString handle = s_outputNames[random.bounded(int(s_outputNames.size()))];
+        ZoneCore *zone = registry->zone(handle);
+
+        switch (operation) {
+        case MapWindow:
+            if (toplevels.size() < 200) {
+                toplevels.emplace_back();
+            }
+            break;
+        case DestroyToplevel:
+            if (toplevel) {
+                registry->removeToplevel(toplevel->toplevel.get());
+                QVERIFY(!registry->item(toplevel->toplevel.get()));
+                toplevels.erase(toplevels.begin() + index);
+            }
+            break;
+        case CreateItem:
+            // get_zone_item, possibly for a toplevel whose window closed already
+            if (toplevel && !item) {
+                QVERIFY(registry->addItem(toplevel->toplevel.get(), new StandInWindowItem(m_metrics.get(), toplevel->window.get())));
+            }
+            break;
+        case DestroyItem:
+            if (item) {
+                delete item;
+                QVERIFY(!registry->item(toplevel->toplevel.get()));
+            }
+            break;
+        case AddItem:
+            if (item && zone) {
+                const bool added = zone->addItem(item);
+                QVERIFY(!added || item->zone() == zone);
+            }
+            break;
+        case RemoveItem:
+            if (item && zone) {
+                const bool wasMember = item->zone() == zone;
+                QCOMPARE(zone->removeItem(item), wasMember);
+                QVERIFY(item->zone() != zone);
+            }
+            break;
+        case SetPosition:
+            if (item) {
+                const bool answered = item->setPosition(QPoint(random.bounded(-500, 4000), random.bounded(-500, 2500)));
+                QCOMPARE(answered, item->isInert() || (item->zone() && item->window()));
+            }
+            break;
+        case Commit:
+            if (item && item->zone()) {
+                item->zone()->applyPendingPosition(item);
+            }
+            break;
+        case CloseWindow:
+            if (toplevel && toplevel->window) {
+                if (item) {
+                    item->closeWindow();
+                    QVERIFY(item->isInert());
+                    QCOMPARE(item->closedEvents, 1);
+                }
+                toplevel->window.reset();
+            }
+            break;
+        case PlugOutput:
+            if (!zone) {
+                registry->addZone(new StandInZone({QRect(random.bounded(4) * 1920, 0, 1920, 1080)}, handle, m_metrics.get()));
+            }
+            break;
+        case UnplugOutput:
+            registry->removeZone(handle);
+            break;
+        case ChangeOutput:
+            if (zone) {
+                zone->setArea(QRect(random.bounded(4) * 1920, random.bounded(2) * 32, 1920, 1080 - random.bounded(2) * 32));
+            }
+            break;
+        case ChangeWindow:
+            if (toplevel && toplevel->window) {
+                toplevel->window->geometry.translate(random.bounded(-50, 50), random.bounded(-50, 50));
+                toplevel->window->margins = QMargins(0, random.bounded(2) * 24, 0, 0);
+                if (item && item->zone()) {
+                    item->zone()->markDirty(item);
+                }
+            }
+            break;
+        case Refresh:
+            registry->refreshZones();
+            break;
+        case OperationCount:
+            Q_UNREACHABLE();
+        }
+
+        const auto &zones = registry->zones();
+        QCOMPARE(m_metrics->itemsAlive, int(registry->items().size()));
+        QCOMPARE(m_metrics->zonesAlive, int(zones.size()));
+        qsizetype members = 0;
+        for (const auto &candidate : toplevels) {
+            auto candidateItem = static_cast<StandInWindowItem *>(registry->item(candidate.toplevel.get()));
+            if (!candidateItem) {
+                continue;
+            }
+            QCOMPARE(candidateItem->eventsWhileInert, 0);
+            // a closed window is gone, its item must not point to it
+            QVERIFY(!candidateItem->window() || candidateItem->window() == candidate.window.get());
+            if (candidateItem->isInert()) {
+                QVERIFY(!candidateItem->zone());
+                QVERIFY(!candidateItem->window());
+            }
+            if (auto itemZone = candidateItem->zone()) {
+                QCOMPARE(zones.value(itemZone->handle()), itemZone);
+                QVERIFY(itemZone->items().contains(candidateItem));
+                ++members;
+            }
+        }
+        for (auto candidate : zones) {
+            members -= candidate->items().size();
+        }
+        QCOMPARE(members, qsizetype(0));
+    }
+
+    // the compositor going away with zones and items left
+    registry.reset();
+    toplevels.clear();
+    QCOMPARE(m_metrics->itemsAlive, 0);
+    QCOMPARE(m_metrics->zonesAlive, 0);
+
+    if (warmRss > 0) {
+        const qint64 growth = residentSetSize() - warmRss;
+        qDebug() << "RSS growth after warm up" << growth / 1024 << "KiB";
+        QVERIFY2(growth < 8 * 1024 * 1024, qPrintable(QStringLiteral("RSS grew by %1 KiB").arg(growth / 1024)));
+    }
+}
+
+QTEST_GUILESS_MAIN(ZoneLifecycleTest)
+
+#include "zonelifecycletest.moc"
@@ -0,0 +1,352 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "standins.h"
+#include "zonesmetrics.h"
+
+using namespace KWin;
+
+// Every allocation of the benchmark goes through here so that the hot paths
+// can be checked to not allocate. The size is kept in front of each block
+// to know how many bytes are live.
+static qint64 s_allocations = 0;
+static qint64 s_liveBytes = 0;
+static constexpr std::size_t s_header = alignof(std::max_align_t);
+
+void *operator new(std::size_t size)
+{
+    auto block = static_cast<char *>(std::malloc(size + s_header));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t *>(block) = size;
+    ++s_allocations;
+    s_liveBytes += size;
+    return block + s_header;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (!pointer) {
+        return;
+    }
+    auto block = static_cast<char *>(pointer) - s_header;
+    s_liveBytes -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+static const int s_itemCount = 10000;
+
+// KWin's Window and SurfaceInterface, as far as zone items connect to them
+class BenchmarkWindow : public QObject
+{
+    Q_OBJECT
+Q_SIGNALS:
+    void frameGeometryChanged();
+    void clientGeometryChanged();
+    void closed();
+};
+
+class BenchmarkSurface : public QObject
+{
+    Q_OBJECT
+Q_SIGNALS:
+    void committed();
+};
+
+/**
+ * Wired like ExtZoneItemV1Interface: a QObject with the same connections,
+ * handling set_position and commits the same way. Only the wl_resource and
+ * its Resource wrapper are missing.
+ */
+class BenchmarkItem : public QObject, public StandInItem
+{
+    Q_OBJECT
+public:
+    BenchmarkItem(ZonesMetrics *metrics, BenchmarkWindow *window, BenchmarkSurface *surface)
+        : StandInItem(metrics, QStringLiteral("/usr/bin/benchmark"))
+    {
+        connect(window, &BenchmarkWindow::frameGeometryChanged, this, &BenchmarkItem::markDirty);
+        connect(window, &BenchmarkWindow::clientGeometryChanged, this, &BenchmarkItem::markDirty);
+        connect(window, &BenchmarkWindow::closed, this, &BenchmarkItem::windowClosed);
+        connect(surface, &BenchmarkSurface::committed, this, &BenchmarkItem::applyPendingPosition);
+    }
+
+private:
+    void applyPendingPosition()
+    {
+        if (auto zone = this->zone()) {
+            zone->applyPendingPosition(this);
+        }
+    }
+
+    void markDirty()
+    {
+        if (auto zone = this->zone()) {
+            zone->markDirty(this);
+        }
+    }
+
+    void windowClosed()
+    {
+        closeWindow();
+    }
+};
+
+class ZonesBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkMemoryPerItem();
+    void benchmarkSetPosition();
+    void benchmarkThemeSwitch();
+    void benchmarkSessionStart();
+    void benchmarkBatchSessionStart();
+
+private:
+    std::unique_ptr<ZonesMetrics> m_metrics;
+};
+
+/// Windows and surfaces exist whether or not the client makes zone items
+struct BenchmarkWindows
+{
+    BenchmarkWindows(int count)
+        : windows(count)
+        , surfaces(count)
+    {
+    }
+
+    std::vector<BenchmarkWindow> windows;
+    std::vector<BenchmarkSurface> surfaces;
+};
+
+void ZonesBenchmark::initTestCase()
+{
+    m_metrics = std::make_unique<ZonesMetrics>(QDBusConnection(QStringLiteral("kwinzones-no-bus")));
+}
+
+void ZonesBenchmark::cleanupTestCase()
+{
+    m_metrics.reset();
+}
+
+/**
+ * What a zone item costs: the item with its connections to the window and
+ * surface, and its state in the zone.
+ */
+void ZonesBenchmark::benchmarkMemoryPerItem()
+{
+    StandInZone zone({QRect(0, 0, 3840, 2160)}, QStringLiteral("DP-1"), m_metrics.get());
+    BenchmarkWindows windows(s_itemCount);
+    std::vector<std::unique_ptr<BenchmarkItem>> items;
+    items.reserve(s_itemCount);
+
+    const qint64 bytesBefore = s_liveBytes;
+    for (int i = 0; i < s_itemCount; ++i) {
+        items.push_back(std::make_unique<BenchmarkItem>(m_metrics.get(), &windows.windows[i], &windows.surfaces[i]));
+    }
+    const qint64 itemBytes = (s_liveBytes - bytesBefore) / s_itemCount;
+    for (const auto &item : items) {
+        zone.addItem(item.get());
+    }
+    const qint64 zoneBytes = (s_liveBytes - bytesBefore) / s_itemCount - itemBytes;
+
+    qDebug() << "bytes per item:" << itemBytes << "for the item and its connections," << zoneBytes << "in its zone";
+    QCOMPARE(zone.items().size(), qsizetype(s_itemCount));
+    QVERIFY(itemBytes > qint64(sizeof(BenchmarkItem)));
+}
+
+/**
+ * set_position followed by the commit that applies it, dispatched through
+ * the surface's committed signal, for every item of a zone with 10k items,
+ * and the sweep that sends the resulting positions.
+ */
+void ZonesBenchmark::benchmarkSetPosition()
+{
+    StandInZone zone({QRect(0, 0, 3840, 2160)}, QStringLiteral("DP-1"), m_metrics.get());
+    BenchmarkWindows windows(s_itemCount);
+    std::vector<std::unique_ptr<BenchmarkItem>> items;
+    items.reserve(s_itemCount);
+    for (int i = 0; i < s_itemCount; ++i) {
+        items.push_back(std::make_unique<BenchmarkItem>(m_metrics.get(), &windows.windows[i], &windows.surfaces[i]));
+        zone.addItem(items.back().get());
+    }
+
+    int round = 0;
+    auto moveAll = [&] {
+        ++round;
+        for (int i = 0; i < s_itemCount; ++i) {
+            items[i]->setPosition(QPoint((i + round) % 3000, (i * 7 + round) % 1800));
+        }
+        for (auto &surface : windows.surfaces) {
+            Q_EMIT surface.committed();
+        }
+        zone.refreshItems();
+    };
+    moveAll();
+
+    // requests, commits and the events they cause reuse the zone's storage
+    const qint64 allocationsBefore = s_allocations;
+    moveAll();
+    QCOMPARE(s_allocations - allocationsBefore, qint64(0));
+
+    QBENCHMARK {
+        moveAll();
+    }
+    QVERIFY(!zone.hasPendingPosition(items.back().get()));
+    QCOMPARE(items.back()->moves, round);
+}
+
+/**
+ * A decoration theme switch with 50 items: every window gets new borders,
+ * keeping its frame position, and reports the change through both of the
+ * geometry signals. Only the events that tell the client something new are
+ * sent, all in one sweep.
+ */
+void ZonesBenchmark::benchmarkThemeSwitch()
+{
+    static const int s_themeItemCount = 50;
+    StandInZone zone({QRect(0, 0, 3840, 2160)}, QStringLiteral("DP-1"), m_metrics.get());
+    std::vector<StandInItem> items(s_themeItemCount);
+    for (int i = 0; i < s_themeItemCount; ++i) {
+        items[i].geometry.moveTopLeft(QPointF(i * 20, i * 10));
+        zone.addItem(&items[i]);
+    }
+
+    const QMargins themes[] = {QMargins(4, 24, 4, 4), QMargins(0, 32, 0, 0)};
+    int theme = 0;
+    auto switchTheme = [&] {
+        theme = (theme + 1) % 2;
+        for (auto &item : items) {
+            item.margins = themes[theme];
+            zone.markDirty(&item); // frameGeometryChanged
+            zone.markDirty(&item); // clientGeometryChanged
+        }
+        return zone.refreshItems();
+    };
+
+    int events = switchTheme();
+    qDebug() << "events per theme switch with" << s_themeItemCount << "items:" << events;
+    // frame_extents is always followed by a position
+    QCOMPARE(events, 2 * s_themeItemCount);
+
+    // the first sweep sized the dirty list, the next ones reuse it
+    const qint64 allocationsBefore = s_allocations;
+    events = switchTheme();
+    QCOMPARE(s_allocations - allocationsBefore, qint64(0));
+    QCOMPARE(events, 2 * s_themeItemCount);
+
+    // applying the same theme again changes nothing
+    for (auto &item : items) {
+        zone.markDirty(&item);
+    }
+    QCOMPARE(zone.refreshItems(), 0);
+
+    // a resize that keeps the frame in place is not news to the client
+    for (auto &item : items) {
+        item.geometry.setSize(QSizeF(640, 480));
+        zone.markDirty(&item);
+    }
+    QCOMPARE(zone.refreshItems(), 0);
+
+    QBENCHMARK {
+        switchTheme();
+    }
+}
+
+/**
+ * A client mapping 20 windows at session start: each one joins the zone and
+ * asks for a position, which is applied on its next commit, all before the
+ * compositor goes back to sleep.
+ */
+void ZonesBenchmark::benchmarkSessionStart()
+{
+    static const int s_windowCount = 20;
+    QBENCHMARK {
+        StandInZone zone({QRect(0, 0, 3840, 2160)}, QStringLiteral("DP-1"), m_metrics.get());
+        std::vector<StandInItem> items(s_windowCount);
+        for (int i = 0; i < s_windowCount; ++i) {
+            zone.addItem(&items[i]);
+            zone.requestPosition(&items[i], QPoint(i * 40, i * 30));
+            zone.applyPendingPosition(&items[i]);
+        }
+        const int events = zone.refreshItems();
+
+        // one frame_extents and one position per window, where sending the
+        // join right away cost a second position
+        QCOMPARE(zone.entered, s_windowCount);
+        QCOMPARE(events, 2 * s_windowCount);
+        QCOMPARE(items.back().positionEvents, 1);
+        QCOMPARE(items.back().lastPosition, QPoint(760, 570));
+    }
+}
+
+/**
+ * The same session start with the client's requests in one kde_zone_batch_v1
+ * batch: a single commit makes every window join the zone and asks for its
+ * position, under one stacking update and acknowledged by one done event.
+ */
+void ZonesBenchmark::benchmarkBatchSessionStart()
+{
+    static const int s_windowCount = 20;
+    QObject toplevels[s_windowCount];
+    StandInWindow windows[s_windowCount];
+    QBENCHMARK {
+        ZoneRegistry registry;
+        registry.addZone(new StandInZone({QRect(0, 0, 3840, 2160)}, QStringLiteral("DP-1"), m_metrics.get()));
+        auto zone = static_cast<StandInZone *>(registry.zone(QStringLiteral("DP-1")));
+        ZoneBatch batch;
+        StandInWindowItem *items[s_windowCount];
+        for (int i = 0; i < s_windowCount; ++i) {
+            items[i] = new StandInWindowItem(m_metrics.get(), &windows[i]);
+            registry.addItem(&toplevels[i], items[i]);
+            batch.addItem(zone, items[i]);
+            batch.setPosition(items[i], QPoint(i * 40, i * 30));
+        }
+        QCOMPARE(batch.commit(registry), 2 * s_windowCount);
+
+        // the surfaces commit, then the sweep
+        for (auto item : items) {
+            zone->applyPendingPosition(item);
+        }
+        QCOMPARE(zone->entered, s_windowCount);
+        QCOMPARE(registry.refreshZones(), 2 * s_windowCount);
+        QCOMPARE(items[s_windowCount - 1]->lastPosition, QPoint(760, 570));
+    }
+}
+
+QTEST_GUILESS_MAIN(ZonesBenchmark)
+
+#include "zonesbenchmark.moc"
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusServer>
+#include <QTest>
+
+#include <memory>
+#include <optional>
+
+#include "standins.h"
+#include "zonesmetrics.h"
+
+using namespace KWin;
+
+/**
+ * Talks to ZonesMetrics over a private peer to peer bus, the same way
+ * qdbus does on the session bus.
+ */
+class ZonesMetricsTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testSnapshot();
+    void testReset();
+    void testWithoutMetrics();
+
+private:
+    QVariantMap call(const QString &method);
+
+    std::unique_ptr<QDBusServer> m_server;
+    std::unique_ptr<ZonesMetrics> m_metrics;
+    std::unique_ptr<StandInZone> m_zone;
+    std::unique_ptr<StandInItem> m_item;
+};
+
+static const QString s_peerName = QStringLiteral("kwinzones-metrics-peer");
+
+// nested maps arrive as D-Bus arguments
+static QVariantMap toMap(const QVariant &value)
+{
+    if (value.metaType() == QMetaType::fromType<QDBusArgument>()) {
+        return qdbus_cast<QVariantMap>(value.value<QDBusArgument>());
+    }
+    return value.toMap();
+}
+
+void ZonesMetricsTest::initTestCase()
+{
+    m_server = std::make_unique<QDBusServer>();
+    QVERIFY(m_server->isConnected());
+    // the compositor's end of the bus
+    std::optional<QDBusConnection> compositorBus;
+    QObject context;
+    connect(m_server.get(), &QDBusServer::newConnection, &context, [&compositorBus](const QDBusConnection &connection) {
+        compositorBus = connection;
+    });
+    const QDBusConnection peer = QDBusConnection::connectToPeer(m_server->address(), s_peerName);
+    QVERIFY(peer.isConnected());
+    QTRY_VERIFY(compositorBus.has_value());
+
+    m_metrics = std::make_unique<ZonesMetrics>(*compositorBus);
+}
+
+void ZonesMetricsTest::cleanupTestCase()
+{
+    m_item.reset();
+    m_zone.reset();
+    m_metrics.reset();
+    QDBusConnection::disconnectFromPeer(s_peerName);
+    m_server.reset();
+}
+
+QVariantMap ZonesMetricsTest::call(const QString &method)
+{
+    const QDBusMessage message = QDBusMessage::createMethodCall(QString(), QStringLiteral("/Zones"), QStringLiteral("org.kde.KWin.Zones.Metrics"), method);
+    // both ends live on this thread, keep the event loop running
+    const QDBusMessage reply = QDBusConnection(s_peerName).call(message, QDBus::BlockWithGui);
+    if (reply.type() != QDBusMessage::ReplyMessage) {
+        qWarning() << "call failed" << method << reply.errorMessage();
+        return {};
+    }
+    return reply.arguments().isEmpty() ? QVariantMap() : toMap(reply.arguments().constFirst());
+}
+
+void ZonesMetricsTest::testSnapshot()
+{
+    m_zone = std::make_unique<StandInZone>(QList<QRect>{QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-1"), m_metrics.get());
+    m_item = std::make_unique<StandInItem>(m_metrics.get(), QStringLiteral("/usr/bin/zoneclient"));
+
+    // not in a zone yet, the request fails and only the client sees it
+    QVERIFY(!m_item->setPosition(QPoint(10, 10)));
+
+    QVERIFY(m_zone->addItem(m_item.get()));
+    QVERIFY(m_item->setPosition(QPoint(10, 10)));
+    QVERIFY(m_zone->applyPendingPosition(m_item.get()));
+    QCOMPARE(m_zone->refreshItems(), 2);
+
+    const QVariantMap snapshot = call(QStringLiteral("snapshot"));
+    QCOMPARE(snapshot.value(QStringLiteral("zonesAlive")).toInt(), 1);
+    QCOMPARE(snapshot.value(QStringLiteral("itemsAlive")).toInt(), 1);
+
+    const QVariantMap zone = toMap(toMap(snapshot.value(QStringLiteral("zones"))).value(QStringLiteral("DP-1")));
+    QCOMPARE(zone.value(QStringLiteral("setPositionRequests")).toULongLong(), 1ull);
+    QCOMPARE(zone.value(QStringLiteral("positionEvents")).toULongLong(), 1ull);
+    QCOMPARE(zone.value(QStringLiteral("movesApplied")).toULongLong(), 1ull);
+    QVERIFY(!zone.contains(QStringLiteral("positionFailed")));
+    QVERIFY(zone.contains(QStringLiteral("pendingWaitTotalUs")));
+    QVERIFY(zone.contains(QStringLiteral("pendingWaitMaxUs")));
+
+    const QVariantMap clients = toMap(snapshot.value(QStringLiteral("clients")));
+    const QVariantMap clientMap = toMap(clients.value(QStringLiteral("/usr/bin/zoneclient")));
+    QCOMPARE(clientMap.value(QStringLiteral("setPositionRequests")).toULongLong(), 2ull);
+    QCOMPARE(clientMap.value(QStringLiteral("positionFailed")).toULongLong(), 1ull);
+    QCOMPARE(clientMap.value(QStringLiteral("positionEvents")).toULongLong(), 1ull);
+    QCOMPARE(clientMap.value(QStringLiteral("movesApplied")).toULongLong(), 1ull);
+}
+
+void ZonesMetricsTest::testReset()
+{
+    QVERIFY(m_zone);
+    call(QStringLiteral("reset"));
+
+    const QVariantMap snapshot = call(QStringLiteral("snapshot"));
+    // live objects are not counters, they stay
+    QCOMPARE(snapshot.value(QStringLiteral("zonesAlive")).toInt(), 1);
+    QCOMPARE(snapshot.value(QStringLiteral("itemsAlive")).toInt(), 1);
+
+    // entries stay too, zeroed
+    const QVariantMap zone = toMap(toMap(snapshot.value(QStringLiteral("zones"))).value(QStringLiteral("DP-1")));
+    QCOMPARE(zone.value(QStringLiteral("setPositionRequests")).toULongLong(), 0ull);
+    QCOMPARE(zone.value(QStringLiteral("positionEvents")).toULongLong(), 0ull);
+    QCOMPARE(zone.value(QStringLiteral("movesApplied")).toULongLong(), 0ull);
+    QCOMPARE(zone.value(QStringLiteral("pendingWaitMaxUs")).toLongLong(), 0ll);
+    const QVariantMap clientMap = toMap(toMap(snapshot.value(QStringLiteral("clients"))).value(QStringLiteral("/usr/bin/zoneclient")));
+    QCOMPARE(clientMap.value(QStringLiteral("setPositionRequests")).toULongLong(), 0ull);
+    QCOMPARE(clientMap.value(QStringLiteral("positionFailed")).toULongLong(), 0ull);
+
+    // and keep counting afterwards
+    QVERIFY(m_item->setPosition(QPoint(20, 20)));
+    const QVariantMap again = call(QStringLiteral("snapshot"));
+    QCOMPARE(toMap(toMap(again.value(QStringLiteral("zones"))).value(QStringLiteral("DP-1"))).value(QStringLiteral("setPositionRequests")).toULongLong(), 1ull);
+    QCOMPARE(toMap(toMap(again.value(QStringLiteral("clients"))).value(QStringLiteral("/usr/bin/zoneclient"))).value(QStringLiteral("setPositionRequests")).toULongLong(), 1ull);
+}
+
+void ZonesMetricsTest::testWithoutMetrics()
+{
+    // zones and items that report nowhere still do their job
+    StandInZone zone({QRect(0, 0, 1920, 1080)}, QStringLiteral("DP-2"));
+    StandInItem item;
+    QVERIFY(!item.setPosition(QPoint(10, 10)));
+    QVERIFY(zone.addItem(&item));
+    QVERIFY(item.setPosition(QPoint(10, 10)));
+    QVERIFY(zone.applyPendingPosition(&item));
+    QCOMPARE(zone.refreshItems(), 2);
+    QCOMPARE(item.lastPosition, QPoint(10, 10));
+    zone.removeItem(&item);
+
+    const QVariantMap snapshot = call(QStringLiteral("snapshot"));
+    QVERIFY(!toMap(snapshot.value(QStringLiteral("zones"))).contains(QStringLiteral("DP-2")));
+    QCOMPARE(snapshot.value(QStringLiteral("zonesAlive")).toInt(), 1);
+    QCOMPARE(snapshot.value(QStringLiteral("itemsAlive")).toInt(), 1);
+}
+
+QTEST_GUILESS_MAIN(ZonesMetricsTest)
+
+#include "zonesmetricstest.moc"
@@ -3,7 +3,9 @@
 
 #include "zonemanager.h"
 #include "zoneitemattached.h"
+#include "zonerecorder.h"
 
+#include <QAbstractEventDispatcher>
 #include <QGuiApplication>
 #include <QtWaylandClient/private/qwaylandwindow_p.h>
 #include <QPlatformSurfaceEvent>
@@ -13,6 +15,7 @@
 #include <kwinzonesclientlogging.h>
 
 Q_GLOBAL_STATIC(ZoneManager, s_manager)
+Q_GLOBAL_STATIC(ZoneBatchManager, s_batchManager)
 
 ZoneManager::ZoneManager()
     : QWaylandClientExtensionTemplate<ZoneManager>(1)
@@ -21,6 +24,9 @@ ZoneManager::ZoneManager()
     connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this] (QScreen *screen) {
         m_zones.remove(screen);
     });
+    // Windows that became visible are set up before the client goes to
+    // sleep, without waiting for another event loop iteration.
+    connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &ZoneManager::manageScheduledSurfaces);
 }
 
 ZoneZone *ZoneManager::fetchZone(QScreen *screen)
@@ -30,6 +36,7 @@ ZoneZone *ZoneManager::fetchZone(QScreen *screen)
         auto output = (::wl_output *)QGuiApplication::platformNativeInterface()->nativeResourceForScreen("output", screen);
         Q_ASSERT(output);
         ret = new ZoneZone(s_manager->get_zone(output));
+        ZoneRecorder::record(ZoneRecording::RecordType::GetZone, ret->object(), {qint32(ZoneRecorder::id(output))});
     }
     return ret;
 }
@@ -39,6 +46,81 @@ bool ZoneManager::isActive()
     return s_manager->isInitialized();
 }
 
+void ZoneManager::scheduleManageSurface(ZoneItem *item)
+{
+    if (m_scheduledItems.contains(item)) {
+        return;
+    }
+    m_scheduledItems.append(item);
+}
+
+void ZoneManager::manageScheduledSurfaces()
+{
+    if (m_scheduledItems.isEmpty()) {
+        return;
+    }
+    const auto items = std::exchange(m_scheduledItems, {});
+    qCDebug(KWINZONES_CLIENT) << "managing" << items.size() << "surfaces";
+
+    if (!m_batch && s_batchManager->isActive()) {
+        m_batch = std::make_unique<ZoneBatch>(s_batchManager->get_batch());
+    }
+    m_batching = true;
+    for (const QPointer<ZoneItem> &item : items) {
+        if (item) {
+            item->manageSurface();
+        }
+    }
+    m_batching = false;
+    if (m_batch) {
+        m_batch->commitRequests();
+    }
+
+    // the event dispatcher may flush the display before or after us
+    auto display = (::wl_display *)QGuiApplication::platformNativeInterface()->nativeResourceForIntegration("wl_display");
+    if (display) {
+        wl_display_flush(display);
+    }
+}
+
+ZoneBatchManager::ZoneBatchManager()
+    : QWaylandClientExtensionTemplate<ZoneBatchManager>(1)
+{
+    initialize();
+}
+
+ZoneBatch::ZoneBatch(::kde_zone_batch_v1 *batch)
+    : QtWayland::kde_zone_batch_v1(batch)
+{
+}
+
+void ZoneBatch::addItem(::xx_zone_v1 *zone, ::xx_zone_item_v1 *item)
+{
+    add_item(zone, item);
+    ++m_requests;
+}
+
+void ZoneBatch::setPosition(::xx_zone_item_v1 *item, const QPoint &position)
+{
+    set_position(item, position.x(), position.y());
+    ++m_requests;
+}
+
+void ZoneBatch::commitRequests()
+{
+    if (m_requests == 0) {
+        return;
+    }
+    qCDebug(KWINZONES_CLIENT) << "committing a batch of" << m_requests << "requests";
+    m_requests = 0;
+    commit();
+}
+
+void ZoneBatch::kde_zone_batch_v1_done(uint32_t count)
+{
+    qCDebug(KWINZONES_CLIENT) << "batch applied" << count << "requests";
+}
+
 ZoneItem::ZoneItem(QWindow *window)
     : QtWayland::xx_zone_item_v1()
     , m_window(window)
@@ -46,12 +128,14 @@ ZoneItem::ZoneItem(QWindow *window)
     Q_ASSERT(m_window);
     Q_ASSERT(m_window->isTopLevel());
 #if QT_VERSION < QT_VERSION_CHECK(6, 8, 0)
-    connect(window, &QWindow::visibilityChanged, this, &ZoneItem::manageSurface, Qt::QueuedConnection);
+    connect(window, &QWindow::visibilityChanged, this, [this] {
+        s_manager->scheduleManageSurface(this);
+    });
 #else
     window->installEventFilter(this);
 #endif
     if (window->isVisible()) {
-        manageSurface();
+        s_manager->scheduleManageSurface(this);
     }
 }
 
@@ -65,8 +149,9 @@ bool ZoneItem::eventFilter(QObject *watched, QEvent *event)
     if (event->type() == QEvent::PlatformSurface) {
         auto waylandWindow = window->nativeInterface<QNativeInterface::Private::QWaylandWindow>();
         Q_ASSERT(waylandWindow);
-        connect(waylandWindow, &QNativeInterface::Private::QWaylandWindow::surfaceRoleCreated,
-                this, &ZoneItem::manageSurface);
+        connect(waylandWindow, &QNativeInterface::Private::QWaylandWindow::surfaceRoleCreated, this, [this] {
+            s_manager->scheduleManageSurface(this);
+        });
         window->removeEventFilter(this);
     }
     return false;
@@ -77,6 +162,7 @@ void ZoneItem::manageSurface()
 {
     if (!m_window->isVisible()) {
         if (isInitialized()) {
+            ZoneRecorder::record(ZoneRecording::RecordType::DestroyItem, object());
             destroy();
         }
         return;
@@ -89,6 +175,7 @@ void ZoneItem::manageSurface()
     }
 
     ::xx_zone_item_v1 *item = s_manager->get_zone_item(tl);
+    ZoneRecorder::record(ZoneRecording::RecordType::GetZoneItem, item, {qint32(ZoneRecorder::id(tl))});
     init(item);
     xx_zone_item_v1_set_user_data(item, (QtWayland::xx_zone_item_v1 *) this);
     Q_ASSERT(isInitialized());
@@ -104,10 +191,23 @@ void ZoneItem::initZone()
         return;
     }
 
-    m_zone->add_item(object());
+    // the compositor applies batched requests the same way, so they are
+    // recorded as if they had been sent on their own
+    ZoneBatch *batch = s_manager->batch();
+    if (batch) {
+        batch->addItem(m_zone->object(), object());
+    } else {
+        m_zone->add_item(object());
+    }
+    ZoneRecorder::record(ZoneRecording::RecordType::AddItem, m_zone->object(), {qint32(ZoneRecorder::id(object()))});
 
     if (m_requestedPosition) {
-        set_position(m_requestedPosition->x(), m_requestedPosition->y());
+        if (batch) {
+            batch->setPosition(object(), *m_requestedPosition);
+        } else {
+            set_position(m_requestedPosition->x(), m_requestedPosition->y());
+        }
+        ZoneRecorder::record(ZoneRecording::RecordType::SetPosition, object(), {m_requestedPosition->x(), m_requestedPosition->y()});
     }
 }
 
@@ -118,6 +218,7 @@ void ZoneItem::setZone(ZoneZone* zone)
     }
     if (m_zone && object()) {
         m_zone->remove_item(object());
+        ZoneRecorder::record(ZoneRecording::RecordType::RemoveItem, m_zone->object(), {qint32(ZoneRecorder::id(object()))});
     }
     m_zone = zone;
     if (m_zone && object()) {
@@ -141,6 +242,7 @@ void ZoneItem::requestPosition(const QPoint &point)
 
     qCDebug(KWINZONES_CLIENT) << "requesting in" << zone() << "geometry" << point;
     set_position(point.x(), point.y());
+    ZoneRecorder::record(ZoneRecording::RecordType::SetPosition, object(), {point.x(), point.y()});
 }
 
 ZoneItemAttached* ZoneItem::get()
@@ -165,16 +267,62 @@ QPoint ZoneItem::position() const
     return m_pos;
 }
 
+void ZoneItem::xx_zone_item_v1_position(int32_t x, int32_t y)
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::Position, object(), {x, y});
+    updatePosition(m_zone, {x, y});
+}
+
+void ZoneItem::xx_zone_item_v1_frame_extents(int32_t top, int32_t bottom, int32_t left, int32_t right)
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::FrameExtents, object(), {top, bottom, left, right});
+}
+
+void ZoneItem::xx_zone_item_v1_position_failed()
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::PositionFailed, object());
+}
+
+void ZoneItem::xx_zone_item_v1_closed()
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::Closed, object());
+}
+
 ZoneZone::ZoneZone(::xx_zone_v1* zone)
     : QtWayland::xx_zone_v1(zone)
 {
 }
 
+void ZoneZone::xx_zone_v1_size(int32_t width, int32_t height)
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::ZoneSize, object(), {width, height});
+    m_size = {width, height};
+}
+
+void ZoneZone::xx_zone_v1_handle(const QString &handle)
+{
+    ZoneRecorder::recordHandle(object(), handle);
+    m_handle = handle;
+    setObjectName(m_handle);
+}
+
+void ZoneZone::xx_zone_v1_done()
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::ZoneDone, object());
+    Q_EMIT done();
+}
+
 void ZoneZone::xx_zone_v1_item_entered(xx_zone_item_v1* item)
 {
+    ZoneRecorder::record(ZoneRecording::RecordType::ItemEntered, object(), {qint32(ZoneRecorder::id(item))});
     if (!item) [[unlikely]] {
         qCDebug(KWINZONES_CLIENT) << "unknown item entered";
         return;
     }
     qCDebug(KWINZONES_CLIENT) << "item entered" << QtWayland::xx_zone_item_v1::fromObject(item) << item;
 }
+
+void ZoneZone::xx_zone_v1_item_left(xx_zone_item_v1 *item)
+{
+    ZoneRecorder::record(ZoneRecording::RecordType::ItemLeft, object(), {qint32(ZoneRecorder::id(item))});
+}
@@ -3,12 +3,18 @@
 
 #pragma once
 
+#include <QPointer>
 #include <QWaylandClientExtensionTemplate>
 #include <QWindow>
 #include <QtQmlIntegration>
 #include "qwayland-xx-zones-v1.h"
+#include "qwayland-kde-zones-batch-v1.h"
+
+#include <memory>
 
 class ZoneZone;
+class ZoneItem;
+class ZoneBatch;
 
 class ZoneManager : public QWaylandClientExtensionTemplate<ZoneManager>
                   , public QtWayland::xx_zone_manager_v1
@@ -22,8 +28,51 @@ public:
     ZoneZone *fetchZone(QScreen *screen);
     static bool isActive();
 
+    /**
+     * Queues @p item to get its zone item set up.
+     * Items scheduled during the same event loop iteration are set up before
+     * the client goes back to sleep, in a single batch if the compositor
+     * supports kde_zones_batch_v1.
+     */
+    void scheduleManageSurface(ZoneItem *item);
+
+    /// The batch collecting the requests of the items being set up, if any
+    ZoneBatch *batch() const
+    {
+        return m_batching ? m_batch.get() : nullptr;
+    }
+
 private:
+    void manageScheduledSurfaces();
+
     QHash<QScreen *, ZoneZone *> m_zones;
+    QList<QPointer<ZoneItem>> m_scheduledItems;
+    std::unique_ptr<ZoneBatch> m_batch;
+    bool m_batching = false;
+};
+
+class ZoneBatchManager : public QWaylandClientExtensionTemplate<ZoneBatchManager>
+                       , public QtWayland::kde_zone_batch_manager_v1
+{
+    Q_OBJECT
+public:
+    ZoneBatchManager();
+};
+
+class ZoneBatch : public QtWayland::kde_zone_batch_v1
+{
+public:
+    ZoneBatch(::kde_zone_batch_v1 *batch);
+
+    void addItem(::xx_zone_v1 *zone, ::xx_zone_item_v1 *item);
+    void setPosition(::xx_zone_item_v1 *item, const QPoint &position);
+    /// Commits the requests made since the last commit, if there are any
+    void commitRequests();
+
+private:
+    void kde_zone_batch_v1_done(uint32_t count) override;
+
+    int m_requests = 0;
 };
 
 class ZoneItemAttached;
@@ -34,6 +83,7 @@ class ZoneItem : public QObject, public QtWayland::xx_zone_item_v1
     QML_ELEMENT
     Q_PROPERTY(QPoint position READ position NOTIFY positionChanged)
     Q_PROPERTY(QPoint requestedPosition READ requestedPosition WRITE requestPosition NOTIFY requestedPositionChanged)
+    friend class ZoneManager;
 public:
     ZoneItem(QWindow *window);
     ZoneItemAttached *get();
@@ -59,9 +109,10 @@ private:
 #if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
     bool eventFilter(QObject *watched, QEvent *event) override;
 #endif
-    void xx_zone_item_v1_position(int32_t x, int32_t y) override {
-        updatePosition(m_zone, {x, y});
-    }
+    void xx_zone_item_v1_position(int32_t x, int32_t y) override;
+    void xx_zone_item_v1_frame_extents(int32_t top, int32_t bottom, int32_t left, int32_t right) override;
+    void xx_zone_item_v1_position_failed() override;
+    void xx_zone_item_v1_closed() override;
     void manageSurface();
     void initZone();
 
@@ -84,11 +135,11 @@ public:
 Q_SIGNALS:
     void done();
 private:
-    void xx_zone_v1_size(int32_t width, int32_t height) override { m_size = {width, height}; }
-    void xx_zone_v1_handle(const QString &handle) override { m_handle = handle; setObjectName(m_handle); }
-    void xx_zone_v1_done() override { Q_EMIT done(); }
+    void xx_zone_v1_size(int32_t width, int32_t height) override;
+    void xx_zone_v1_handle(const QString &handle) override;
+    void xx_zone_v1_done() override;
     void xx_zone_v1_item_entered(struct ::xx_zone_item_v1 */*item*/) override;
-    void xx_zone_v1_item_left(struct ::xx_zone_item_v1 */*item*/) override {}
+    void xx_zone_v1_item_left(struct ::xx_zone_item_v1 */*item*/) override;
 
     QSize m_size;
     QString m_handle;
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+// SPDX-License-Identifier: MIT
+
+#include "zonerecorder.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <wayland-client-core.h>
+
+#include <kwinzonesclientlogging.h>
+
+using namespace ZoneRecording;
+
+Q_GLOBAL_STATIC(ZoneRecorder, s_recorder)
+
+ZoneRecorder::ZoneRecorder()
+    : m_file(qEnvironmentVariable("KWINZONES_RECORD"))
+{
+    if (m_file.fileName().isEmpty()) {
+        return;
+    }
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWINZONES_CLIENT) << "Could not open recording file" << m_file.fileName() << m_file.errorString();
+        return;
+    }
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_6_0);
+    m_stream << s_magic << s_version << QDateTime::currentMSecsSinceEpoch();
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(1000);
+    QObject::connect(&m_flushTimer, &QTimer::timeout, &m_flushTimer, [this] {
+        m_file.flush();
+    });
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, &m_flushTimer, [this] {
+        m_flushTimer.stop();
+        m_file.flush();
+    });
+    finishRecord();
+    m_timer.start();
+    qCDebug(KWINZONES_CLIENT) << "Recording zones traffic into" << m_file.fileName();
+}
+
+ZoneRecorder::~ZoneRecorder()
+{
+    m_flushTimer.stop();
+    if (m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+bool ZoneRecorder::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIsSet("KWINZONES_RECORD");
+    return enabled && s_recorder->m_file.isOpen();
+}
+
+quint32 ZoneRecorder::id(void *object)
+{
+    return object ? wl_proxy_get_id(static_cast<wl_proxy *>(object)) : 0;
+}
+
+void ZoneRecorder::writeHeader(RecordType type, void *object)
+{
+    m_stream << quint8(type) << id(object) << quint64(m_timer.nsecsElapsed());
+}
+
+void ZoneRecorder::finishRecord()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void ZoneRecorder::record(RecordType type, void *object, std::initializer_list<qint32> args)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    Q_ASSERT(int(args.size()) == argumentCount(type));
+    s_recorder->writeHeader(type, object);
+    for (qint32 arg : args) {
+        s_recorder->m_stream << arg;
+    }
+    s_recorder->finishRecord();
+}
+
+void ZoneRecorder::recordHandle(void *object, const QString &handle)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    s_recorder->writeHeader(RecordType::ZoneHandle, object);
+    s_recorder->m_stream << handle;
+    s_recorder->finishRecord();
+}
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include <initializer_list>
+#include "zonerecording.h"
+
+/**
+ * Records the xx-zones traffic of this process into a file so it can be
+ * analysed and replayed with kwinzones-replay.
+ *
+ * Recording is enabled by setting KWINZONES_RECORD to the path of the
+ * output file. When unset, record() is a no-op. Records are buffered and
+ * written out at most a second after they were made and when the
+ * application quits, so a crashing client loses its last second at most.
+ */
+class ZoneRecorder
+{
+public:
+    ZoneRecorder();
+    ~ZoneRecorder();
+
+    static bool isEnabled();
+    static void record(ZoneRecording::RecordType type, void *object, std::initializer_list<qint32> args = {});
+    static void recordHandle(void *object, const QString &handle);
+
+    /// @returns the protocol id of @p object, 0 if there is none
+    static quint32 id(void *object);
+
+private:
+    void writeHeader(ZoneRecording::RecordType type, void *object);
+    void finishRecord();
+
+    QFile m_file;
+    QDataStream m_stream;
+    QElapsedTimer m_timer;
+    QTimer m_flushTimer;
+};
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * On-disk format shared by the client recorder and kwinzones-replay.
+ *
+ * A recording starts with a header (magic, version, wall clock start in
+ * msecs since epoch) followed by records written with QDataStream:
+ * type (quint8), object id (quint32), monotonic timestamp in nsecs since the
+ * start of the recording (quint64) and then the arguments of the record.
+ * Arguments are qint32 values, except for ZoneHandle which carries a QString.
+ */
+namespace ZoneRecording
+{
+static constexpr quint32 s_magic = 0x4b575a52; // "KWZR"
+static constexpr quint16 s_version = 1;
+
+enum class RecordType : quint8 {
+    // requests: object id is the sender
+    GetZoneItem, // item, args: toplevel id
+    GetZone, // zone, args: output id
+    AddItem, // zone, args: item id
+    RemoveItem, // zone, args: item id
+    SetPosition, // item, args: x, y
+    DestroyItem, // item
+    // events: object id is the receiver
+    ZoneSize, // zone, args: width, height
+    ZoneHandle, // zone, args: QString handle
+    ZoneDone, // zone
+    ItemEntered, // zone, args: item id
+    ItemLeft, // zone, args: item id
+    FrameExtents, // item, args: top, bottom, left, right
+    Position, // item, args: x, y
+    PositionFailed, // item
+    Closed, // item
+    Count,
+};
+
+constexpr int argumentCount(RecordType type)
+{
+    switch (type) {
+    case RecordType::GetZoneItem:
+    case RecordType::GetZone:
+    case RecordType::AddItem:
+    case RecordType::RemoveItem:
+    case RecordType::ItemEntered:
+    case RecordType::ItemLeft:
+        return 1;
+    case RecordType::SetPosition:
+    case RecordType::ZoneSize:
+    case RecordType::Position:
+        return 2;
+    case RecordType::FrameExtents:
+        return 4;
+    case RecordType::DestroyItem:
+    case RecordType::ZoneHandle:
+    case RecordType::ZoneDone:
+    case RecordType::PositionFailed:
+    case RecordType::Closed:
+    case RecordType::Count:
+        return 0;
+    }
+    return 0;
+}
+
+constexpr const char *typeName(RecordType type)
+{
+    switch (type) {
+    case RecordType::GetZoneItem:
+        return "get_zone_item";
+    case RecordType::GetZone:
+        return "get_zone";
+    case RecordType::AddItem:
+        return "add_item";
+    case RecordType::RemoveItem:
+        return "remove_item";
+    case RecordType::SetPosition:
+        return "set_position";
+    case RecordType::DestroyItem:
+        return "destroy";
+    case RecordType::ZoneSize:
+        return "size";
+    case RecordType::ZoneHandle:
+        return "handle";
+    case RecordType::ZoneDone:
+        return "done";
+    case RecordType::ItemEntered:
+        return "item_entered";
+    case RecordType::ItemLeft:
+        return "item_left";
+    case RecordType::FrameExtents:
+        return "frame_extents";
+    case RecordType::Position:
+        return "position";
+    case RecordType::PositionFailed:
+        return "position_failed";
+    case RecordType::Closed:
+        return "closed";
+    case RecordType::Count:
+        break;
+    }
+    return "unknown";
+}
+}
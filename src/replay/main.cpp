@@ -0,0 +1,490 @@
+// SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+// SPDX-License-Identifier: MIT
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QPoint>
+#include <QSize>
+#include <QTextStream>
+
+#include <map>
+#include <memory>
+#include <optional>
+
+#include "zonecore.h"
+#include "zonerecording.h"
+
+using namespace KWin;
+using namespace ZoneRecording;
+
+struct Latency
+{
+    void add(quint64 nsecs)
+    {
+        min = count ? std::min(min, nsecs) : nsecs;
+        max = std::max(max, nsecs);
+        total += nsecs;
+        ++count;
+    }
+
+    void add(const Latency &other)
+    {
+        if (!other.count) {
+            return;
+        }
+        min = count ? std::min(min, other.min) : other.min;
+        max = std::max(max, other.max);
+        total += other.total;
+        count += other.count;
+    }
+
+    quint64 min = 0;
+    quint64 max = 0;
+    quint64 total = 0;
+    quint64 count = 0;
+};
+
+/**
+ * How the set_position requests of an item were answered. The first position
+ * or position_failed after a request answers it, even if the compositor had
+ * to move the window elsewhere to keep it reachable. Positions nobody asked
+ * for are counted apart.
+ */
+struct Answers
+{
+    void request(quint64 timestamp, const QPoint &position)
+    {
+        pendingSince = timestamp;
+        requested = position;
+        ++setPositions;
+    }
+
+    void position(quint64 timestamp, const QPoint &position)
+    {
+        last = position;
+        if (!pendingSince) {
+            ++unsolicited;
+            return;
+        }
+        if (position != requested) {
+            ++clamped;
+        }
+        latency.add(timestamp - *pendingSince);
+        pendingSince.reset();
+    }
+
+    void failed(quint64 timestamp)
+    {
+        ++failures;
+        if (pendingSince) {
+            latency.add(timestamp - *pendingSince);
+            pendingSince.reset();
+        }
+    }
+
+    std::optional<quint64> pendingSince;
+    QPoint requested;
+    QPoint last;
+    int setPositions = 0;
+    int failures = 0;
+    int clamped = 0;
+    int unsolicited = 0;
+    Latency latency;
+};
+
+struct RecordedItem
+{
+    quint32 zone = 0;
+    bool closed = false;
+    Answers answers;
+};
+
+/// The time of the recording the replay is at, and what it sent so far
+struct ReplayClock
+{
+    quint64 now = 0;
+    int events = 0;
+};
+
+/// Plays the part of the compositor's window for a recorded item
+class ReplayItem : public ZoneCoreItem
+{
+public:
+    ReplayItem(ReplayClock *clock, const QSize &windowSize)
+        : geometry(QPointF(0, 0), windowSize)
+        , m_clock(clock)
+    {
+    }
+
+    QRectF frameGeometry() const override
+    {
+        return geometry;
+    }
+    QMargins frameMargins() const override
+    {
+        return QMargins();
+    }
+    void move(const QPoint &position) override
+    {
+        geometry.moveTopLeft(position);
+    }
+    void sendFrameExtents(const QMargins &margins) override
+    {
+        Q_UNUSED(margins)
+        ++m_clock->events;
+    }
+    void sendPosition(const QPoint &position) override
+    {
+        ++m_clock->events;
+        answers.position(m_clock->now, position);
+    }
+    void sendPositionFailed() override
+    {
+        ++m_clock->events;
+        answers.failed(m_clock->now);
+    }
+    void sendClosed() override
+    {
+        ++m_clock->events;
+    }
+
+    QRectF geometry;
+    Answers answers;
+
+private:
+    ReplayClock *const m_clock;
+};
+
+/**
+ * Runs the recorded requests through ZoneCore, the bookkeeping of the KWin
+ * plugin, as a compositor that commits and sweeps whenever the recording
+ * shows the real one answering.
+ */
+struct Replay
+{
+    ZoneCore *zone(quint32 id)
+    {
+        auto &zone = zones[id];
+        if (!zone) {
+            // resized once the recording tells the zone's size
+            zone = std::make_unique<ZoneCore>(QList<QRect>{QRect()}, QStringLiteral("zone@%1").arg(id));
+        }
+        return zone.get();
+    }
+
+    ReplayItem *item(quint32 id) const
+    {
+        auto it = items.find(id);
+        return it == items.end() ? nullptr : it->second.get();
+    }
+
+    // the surfaces commit, then the geometry changes are sent
+    void sweep(quint64 timestamp)
+    {
+        clock.now = timestamp;
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto &[id, item] : items) {
+            if (auto itemZone = item->zone()) {
+                itemZone->applyPendingPosition(item.get());
+            }
+        }
+        for (const auto &[id, zone] : zones) {
+            if (zone->hasDirtyItems()) {
+                zone->refreshItems();
+            }
+        }
+        coreNsecs += timer.nsecsElapsed();
+        ++sweeps;
+        pending = false;
+    }
+
+    QSize windowSize;
+    ReplayClock clock;
+    // declared first so they go last, items leave their zones on the way out
+    std::map<quint32, std::unique_ptr<ZoneCore>> zones;
+    std::map<quint32, std::unique_ptr<ReplayItem>> items;
+    qint64 coreNsecs = 0;
+    int sweeps = 0;
+    bool pending = false;
+};
+
+static QString formatNsecs(quint64 nsecs)
+{
+    return QStringLiteral("%1ms").arg(nsecs / 1000000.0, 0, 'f', 3);
+}
+
+static void printLatency(QTextStream &out, const Latency &latency)
+{
+    if (!latency.count) {
+        out << "no set_position answered" << Qt::endl;
+        return;
+    }
+    out << "set_position latency: min " << formatNsecs(latency.min) << " avg " << formatNsecs(latency.total / latency.count) << " max "
+        << formatNsecs(latency.max) << " (" << latency.count << " answered)" << Qt::endl;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("kwinzones-replay"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("Replays a KWINZONES_RECORD recording against the zone bookkeeping of KWin and compares the outcome with the recording"));
+    parser.addHelpOption();
+    QCommandLineOption verboseOption({QStringLiteral("v"), QStringLiteral("verbose")}, QStringLiteral("Print every recorded message"));
+    parser.addOption(verboseOption);
+    QCommandLineOption windowSizeOption(QStringLiteral("window-size"),
+                                        QStringLiteral("Frame size of the replayed windows, the recording does not have it"),
+                                        QStringLiteral("WIDTHxHEIGHT"),
+                                        QStringLiteral("800x600"));
+    parser.addOption(windowSizeOption);
+    parser.addPositionalArgument(QStringLiteral("recording"), QStringLiteral("File written by a client running with KWINZONES_RECORD"));
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    Replay replay;
+    const QStringList windowSize = parser.value(windowSizeOption).split(QLatin1Char('x'));
+    if (windowSize.size() == 2) {
+        replay.windowSize = QSize(windowSize[0].toInt(), windowSize[1].toInt());
+    }
+    if (replay.windowSize.isEmpty()) {
+        qWarning() << "Invalid window size" << parser.value(windowSizeOption);
+        return 1;
+    }
+
+    QFile file(parser.positionalArguments().constFirst());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open" << file.fileName() << file.errorString();
+        return 1;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic;
+    quint16 version;
+    qint64 startTime;
+    stream >> magic >> version >> startTime;
+    if (magic != s_magic || version != s_version) {
+        qWarning() << "Not a zones recording or unsupported version" << Qt::hex << magic << Qt::dec << version;
+        return 1;
+    }
+
+    const bool verbose = parser.isSet(verboseOption);
+    QTextStream out(stdout);
+    out << "Recording started at " << QDateTime::fromMSecsSinceEpoch(startTime).toString(Qt::ISODateWithMs) << Qt::endl;
+
+    // sorted by id so that reports of the same recording are comparable
+    std::map<quint32, RecordedItem> items;
+    QHash<quint32, QString> zoneHandles;
+    QHash<quint32, QSize> zoneSizes;
+    quint64 lastTimestamp = 0;
+    int records = 0;
+    int recordedEvents = 0;
+    int setPositions = 0;
+    // destroyed items are gone from the report, even if events still arrive
+    auto recorded = [&items](quint32 id) -> RecordedItem * {
+        auto it = items.find(id);
+        return it == items.end() ? nullptr : &it->second;
+    };
+
+    while (!stream.atEnd()) {
+        quint8 rawType;
+        quint32 object;
+        quint64 timestamp;
+        stream >> rawType >> object >> timestamp;
+        if (rawType >= quint8(RecordType::Count)) {
+            qWarning() << "Unknown record type" << rawType << "after" << records << "records";
+            return 1;
+        }
+        const auto type = RecordType(rawType);
+        qint32 args[4] = {};
+        QString handle;
+        for (int i = 0; i < argumentCount(type); ++i) {
+            stream >> args[i];
+        }
+        if (type == RecordType::ZoneHandle) {
+            stream >> handle;
+        }
+        if (stream.status() != QDataStream::Ok) {
+            qWarning() << "Truncated recording after" << records << "records";
+            break;
+        }
+        ++records;
+        lastTimestamp = timestamp;
+
+        if (verbose) {
+            out << formatNsecs(timestamp) << ' ' << typeName(type) << '@' << object;
+            for (int i = 0; i < argumentCount(type); ++i) {
+                out << ' ' << args[i];
+            }
+            if (!handle.isEmpty()) {
+                out << ' ' << handle;
+            }
+            out << Qt::endl;
+        }
+
+        const bool isEvent = type >= RecordType::ZoneSize;
+        if (isEvent) {
+            ++recordedEvents;
+            // the real compositor answered by now, so does the replay
+            if (replay.pending) {
+                replay.sweep(timestamp);
+            }
+        } else {
+            replay.pending = true;
+            replay.clock.now = timestamp;
+        }
+
+        switch (type) {
+        case RecordType::GetZoneItem:
+            items[object] = {};
+            replay.items[object] = std::make_unique<ReplayItem>(&replay.clock, replay.windowSize);
+            break;
+        case RecordType::GetZone:
+            replay.zone(object);
+            break;
+        case RecordType::AddItem:
+        case RecordType::ItemEntered:
+            if (auto item = recorded(args[0])) {
+                item->zone = object;
+            }
+            if (type == RecordType::AddItem) {
+                if (auto item = replay.item(args[0])) {
+                    replay.zone(object)->addItem(item);
+                }
+            }
+            break;
+        case RecordType::RemoveItem:
+        case RecordType::ItemLeft:
+            if (auto item = recorded(args[0]); item && item->zone == object) {
+                item->zone = 0;
+            }
+            if (type == RecordType::RemoveItem) {
+                if (auto item = replay.item(args[0])) {
+                    replay.zone(object)->removeItem(item);
+                }
+            }
+            break;
+        case RecordType::SetPosition: {
+            const QPoint position(args[0], args[1]);
+            if (auto item = recorded(object)) {
+                item->answers.request(timestamp, position);
+            }
+            ++setPositions;
+            if (auto item = replay.item(object)) {
+                item->answers.request(timestamp, position);
+                QElapsedTimer timer;
+                timer.start();
+                item->setPosition(position);
+                replay.coreNsecs += timer.nsecsElapsed();
+            }
+            break;
+        }
+        case RecordType::DestroyItem:
+            items.erase(object);
+            replay.items.erase(object);
+            break;
+        case RecordType::Position:
+            if (auto item = recorded(object)) {
+                item->answers.position(timestamp, QPoint(args[0], args[1]));
+            }
+            break;
+        case RecordType::PositionFailed:
+            if (auto item = recorded(object)) {
+                item->answers.failed(timestamp);
+            }
+            break;
+        case RecordType::Closed:
+            if (auto item = recorded(object)) {
+                item->closed = true;
+            }
+            if (auto item = replay.item(object); item && !item->isInert()) {
+                item->closeWindow();
+            }
+            break;
+        case RecordType::ZoneSize:
+            zoneSizes[object] = {args[0], args[1]};
+            replay.zone(object)->setArea(QRect(0, 0, args[0], args[1]));
+            break;
+        case RecordType::ZoneHandle:
+            zoneHandles[object] = handle;
+            break;
+        case RecordType::ZoneDone:
+        case RecordType::FrameExtents:
+        case RecordType::Count:
+            break;
+        }
+    }
+    if (replay.pending) {
+        replay.sweep(lastTimestamp);
+    }
+
+    out << records << " records over " << formatNsecs(lastTimestamp) << Qt::endl;
+
+    Latency recordedLatency;
+    Latency replayedLatency;
+    int mismatches = 0;
+    int positioned = 0;
+    for (const auto &[id, item] : items) {
+        recordedLatency.add(item.answers.latency);
+        if (auto replayed = replay.item(id)) {
+            replayedLatency.add(replayed->answers.latency);
+            if (item.answers.setPositions > 0) {
+                ++positioned;
+                mismatches += replayed->answers.last != item.answers.last;
+            }
+        }
+    }
+
+    out << Qt::endl << "Recorded: " << recordedEvents << " events, ";
+    printLatency(out, recordedLatency);
+    out << "Replayed with " << replay.windowSize.width() << 'x' << replay.windowSize.height() << " windows: " << replay.clock.events
+        << " events in " << replay.sweeps << " sweeps, ";
+    printLatency(out, replayedLatency);
+    out << "Zone bookkeeping took " << formatNsecs(replay.coreNsecs);
+    if (setPositions > 0) {
+        out << ", " << formatNsecs(replay.coreNsecs / setPositions) << " per set_position";
+    }
+    out << Qt::endl;
+    out << "Placement differs for " << mismatches << " of " << positioned << " positioned items" << Qt::endl;
+
+    out << Qt::endl << "Final placement:" << Qt::endl;
+    for (const auto &[id, item] : items) {
+        const Answers &answers = item.answers;
+        out << "item@" << id << " zone " << zoneHandles.value(item.zone, QStringLiteral("<none>"));
+        if (item.zone) {
+            const QSize size = zoneSizes.value(item.zone);
+            out << " (" << size.width() << 'x' << size.height() << ')';
+        }
+        out << " position " << answers.last.x() << ',' << answers.last.y() << " requested " << answers.requested.x() << ','
+            << answers.requested.y() << " set_position " << answers.setPositions << " failed " << answers.failures << " clamped "
+            << answers.clamped << " unsolicited " << answers.unsolicited;
+        if (answers.latency.count) {
+            out << " max latency " << formatNsecs(answers.latency.max);
+        }
+        if (answers.pendingSince) {
+            out << " UNANSWERED";
+        }
+        if (item.closed) {
+            out << " closed";
+        }
+        if (auto replayed = replay.item(id)) {
+            out << " replayed " << replayed->answers.last.x() << ',' << replayed->answers.last.y();
+            if (answers.setPositions > 0 && replayed->answers.last != answers.last) {
+                out << " MISMATCH";
+            }
+        }
+        out << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,479 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "zonecore.h"
+
+#include <limits>
+#include <utility>
+
+namespace KWin
+{
+
+ZoneCoreItem::ZoneCoreItem(ZonesMetrics *metrics, const QString &client)
+    : m_metrics(metrics)
+    , m_clientMetrics(metrics ? metrics->client(client) : nullptr)
+{
+    if (m_metrics) {
+        ++m_metrics->itemsAlive;
+    }
+}
+
+ZoneCoreItem::~ZoneCoreItem()
+{
+    if (m_registry) {
+        m_registry->forgetItem(this);
+    }
+    if (m_zone) {
+        m_zone->detach(this);
+    }
+    if (m_metrics) {
+        --m_metrics->itemsAlive;
+    }
+}
+
+void ZoneCoreItem::makeInert()
+{
+    if (m_zone) {
+        m_zone->removeItem(this);
+    }
+    m_inert = true;
+}
+
+void ZoneCoreItem::closeWindow()
+{
+    makeInert();
+    releaseWindow();
+    sendClosed();
+}
+
+bool ZoneCoreItem::setPosition(const QPoint &position)
+{
+    if (m_inert) {
+        // closed items ignore requests, without an answer
+        return true;
+    }
+    if (m_clientMetrics) {
+        ++m_clientMetrics->setPositionRequests;
+    }
+    if (!m_zone || !hasWindow()) {
+        if (m_clientMetrics) {
+            ++m_clientMetrics->positionFailed;
+        }
+        sendPositionFailed();
+        return false;
+    }
+    m_zone->requestPosition(this, position);
+    return true;
+}
+
+ZoneCore::ZoneCore(const QList<QRect> &partitions, const QString &handle, ZonesMetrics *metrics)
+    : m_metrics(metrics)
+    , m_counters(metrics ? metrics->zone(handle) : nullptr)
+    , m_partitions(partitions)
+    , m_handle(handle)
+{
+    Q_ASSERT(!m_handle.isEmpty());
+    Q_ASSERT(!m_partitions.isEmpty());
+    updateArea();
+    if (m_metrics) {
+        ++m_metrics->zonesAlive;
+    }
+}
+
+ZoneCore::~ZoneCore()
+{
+    for (auto item : std::as_const(m_items)) {
+        item->m_zone = nullptr;
+    }
+    if (m_metrics) {
+        --m_metrics->zonesAlive;
+    }
+}
+
+static void constrainTo(QRect &windowRect, const QRect &area)
+{
+    if (windowRect.left() > area.right()) {
+        windowRect.moveLeft(area.right() - windowRect.width());
+    }
+    if (windowRect.right() < area.left()) {
+        windowRect.moveLeft(area.left());
+    }
+    if (windowRect.top() > area.bottom()) {
+        windowRect.moveTop(area.bottom() - windowRect.height());
+    }
+    if (windowRect.bottom() < area.top()) {
+        windowRect.moveTop(area.top());
+    }
+}
+
+void ZoneCore::constrainPosition(QRect &windowRect) const
+{
+    constrainTo(windowRect, m_area);
+    if (m_partitions.size() == 1) {
+        return;
+    }
+
+    // Composite zones may have gaps between their outputs, make sure the
+    // window ends up on one of them.
+    const QRect *closest = nullptr;
+    int closestDistance = std::numeric_limits<int>::max();
+    for (const QRect &partition : m_partitions) {
+        if (partition.isEmpty()) {
+            continue;
+        }
+        if (partition.intersects(windowRect)) {
+            return;
+        }
+        const int distance = (partition.center() - windowRect.center()).manhattanLength();
+        if (distance < closestDistance) {
+            closestDistance = distance;
+            closest = &partition;
+        }
+    }
+    if (closest) {
+        constrainTo(windowRect, *closest);
+    }
+}
+
+void ZoneCore::setArea(const QRect &area)
+{
+    Q_ASSERT(m_partitions.size() == 1);
+    setPartition(0, area);
+}
+
+void ZoneCore::setPartitions(const QList<QRect> &partitions)
+{
+    Q_ASSERT(!partitions.isEmpty());
+    m_partitions = partitions;
+    updateArea();
+}
+
+void ZoneCore::setPartition(qsizetype index, const QRect &area)
+{
+    if (m_partitions[index] == area) {
+        return;
+    }
+    m_partitions[index] = area;
+    updateArea();
+}
+
+void ZoneCore::updateArea()
+{
+    QRect area;
+    for (const QRect &partition : std::as_const(m_partitions)) {
+        area |= partition;
+    }
+    if (m_area == area) {
+        return;
+    }
+
+    const bool sizeChange = m_area.size() != area.size();
+    const bool originChange = m_area.topLeft() != area.topLeft();
+    m_area = area;
+    if (originChange) {
+        // item positions are relative to the zone's origin
+        for (auto item : std::as_const(m_items)) {
+            markDirty(item);
+        }
+    }
+    if (sizeChange) {
+        areaResized();
+    }
+}
+
+bool ZoneCore::addItem(ZoneCoreItem *item)
+{
+    if (item->m_inert || item->m_zone == this) {
+        return false;
+    }
+    if (item->m_zone) {
+        item->m_zone->removeItem(item);
+    }
+    item->m_zone = this;
+    item->m_slot = m_items.size();
+    m_items.append(item);
+    // the client learns the item's geometry on the next sweep, together
+    // with the outcome of any set_position sent right after add_item
+    m_flags.append(ForceExtents);
+    m_sentMargins.append(QMargins());
+    m_sentPositions.append(QPoint());
+    m_pendingPositions.append(QPoint());
+    m_pendingSince.append({});
+    m_dirtyIndices.append(0);
+    itemEntered(item);
+    markDirty(item);
+    return true;
+}
+
+bool ZoneCore::removeItem(ZoneCoreItem *item)
+{
+    if (item->m_zone != this) {
+        return false;
+    }
+    detach(item);
+    itemLeft(item);
+    return true;
+}
+
+void ZoneCore::detach(ZoneCoreItem *item)
+{
+    Q_ASSERT(item->m_zone == this);
+    const quint32 slot = item->m_slot;
+    if (m_flags[slot] & Dirty) {
+        dropDirty(item);
+    }
+    item->m_zone = nullptr;
+
+    // keep the arrays dense by moving the last item into the free slot
+    const quint32 last = m_items.size() - 1;
+    if (slot != last) {
+        m_items[slot] = m_items[last];
+        m_items[slot]->m_slot = slot;
+        m_flags[slot] = m_flags[last];
+        m_sentMargins[slot] = m_sentMargins[last];
+        m_sentPositions[slot] = m_sentPositions[last];
+        m_pendingPositions[slot] = m_pendingPositions[last];
+        m_pendingSince[slot] = m_pendingSince[last];
+        m_dirtyIndices[slot] = m_dirtyIndices[last];
+    }
+    m_items.removeLast();
+    m_flags.removeLast();
+    m_sentMargins.removeLast();
+    m_sentPositions.removeLast();
+    m_pendingPositions.removeLast();
+    m_pendingSince.removeLast();
+    m_dirtyIndices.removeLast();
+}
+
+void ZoneCore::dropDirty(ZoneCoreItem *item)
+{
+    m_flags[item->m_slot] &= ~Dirty;
+    const quint32 index = m_dirtyIndices[item->m_slot];
+    Q_ASSERT(m_dirtyItems[index] == item);
+    ZoneCoreItem *last = m_dirtyItems.takeLast();
+    if (last != item) {
+        m_dirtyItems[index] = last;
+        m_dirtyIndices[last->m_slot] = index;
+    }
+}
+
+void ZoneCore::requestPosition(ZoneCoreItem *item, const QPoint &position)
+{
+    Q_ASSERT(item->m_zone == this);
+    if (m_counters) {
+        ++m_counters->setPositionRequests;
+    }
+
+    const quint32 slot = item->m_slot;
+    QRect windowRect = item->frameGeometry().toRect();
+    windowRect.moveTopLeft(m_area.topLeft() + position);
+    constrainPosition(windowRect);
+    m_pendingPositions[slot] = windowRect.topLeft();
+    m_pendingSince[slot] = std::chrono::steady_clock::now();
+    m_flags[slot] |= Pending;
+}
+
+bool ZoneCore::hasPendingPosition(const ZoneCoreItem *item) const
+{
+    Q_ASSERT(item->m_zone == this);
+    return m_flags[item->m_slot] & Pending;
+}
+
+std::optional<std::chrono::nanoseconds> ZoneCore::applyPendingPosition(ZoneCoreItem *item)
+{
+    Q_ASSERT(item->m_zone == this);
+    const quint32 slot = item->m_slot;
+    if (!(m_flags[slot] & Pending)) {
+        return std::nullopt;
+    }
+    m_flags[slot] &= ~Pending;
+    const QPoint position = m_pendingPositions[slot];
+    const std::chrono::nanoseconds wait = std::chrono::steady_clock::now() - m_pendingSince[slot];
+    if (m_counters) {
+        m_counters->addPendingWait(wait);
+    }
+    if (item->m_clientMetrics) {
+        item->m_clientMetrics->addPendingWait(wait);
+    }
+    item->move(position);
+
+    // move() may have taken the item out of the zone
+    if (item->m_zone != this) {
+        return wait;
+    }
+    // set_position is answered with a position even if nothing moved
+    m_flags[item->m_slot] |= ForcePosition;
+    markDirty(item);
+    return wait;
+}
+
+void ZoneCore::markDirty(ZoneCoreItem *item)
+{
+    Q_ASSERT(item->m_zone == this);
+    const quint32 slot = item->m_slot;
+    if (m_flags[slot] & Dirty) {
+        return;
+    }
+    m_flags[slot] |= Dirty;
+    m_dirtyIndices[slot] = m_dirtyItems.size();
+    m_dirtyItems.append(item);
+}
+
+int ZoneCore::refreshItems()
+{
+    int events = 0;
+    // indices, the list may grow while the events are sent
+    for (qsizetype i = 0; i < m_dirtyItems.size(); ++i) {
+        ZoneCoreItem *item = m_dirtyItems[i];
+        m_flags[item->m_slot] &= ~Dirty;
+        events += refreshItem(item);
+    }
+    // keeps the capacity for the next sweep
+    m_dirtyItems.clear();
+    return events;
+}
+
+int ZoneCore::refreshItem(ZoneCoreItem *item)
+{
+    Q_ASSERT(item->m_zone == this);
+    const quint32 slot = item->m_slot;
+    int events = 0;
+    const QMargins margins = item->frameMargins();
+    const bool extentsChanged = (m_flags[slot] & ForceExtents) || margins != m_sentMargins[slot];
+    m_flags[slot] &= ~ForceExtents;
+    if (extentsChanged) {
+        m_sentMargins[slot] = margins;
+        item->sendFrameExtents(margins);
+        ++events;
+    }
+
+    // frame_extents must always be followed by a position
+    const QPointF relative = item->frameGeometry().topLeft() - m_area.topLeft();
+    const QPoint position(relative.x(), relative.y());
+    const bool forcePosition = m_flags[slot] & ForcePosition;
+    m_flags[slot] &= ~ForcePosition;
+    if (extentsChanged || forcePosition || position != m_sentPositions[slot]) {
+        m_sentPositions[slot] = position;
+        if (m_counters) {
+            ++m_counters->positionEvents;
+        }
+        if (item->m_clientMetrics) {
+            ++item->m_clientMetrics->positionEvents;
+        }
+        item->sendPosition(position);
+        ++events;
+    }
+    return events;
+}
+
+void ZoneCore::itemEntered(ZoneCoreItem *item)
+{
+    Q_UNUSED(item)
+}
+
+void ZoneCore::itemLeft(ZoneCoreItem *item)
+{
+    Q_UNUSED(item)
+}
+
+void ZoneCore::areaResized()
+{
+}
+
+ZoneRegistry::~ZoneRegistry()
+{
+    // the items detach from their zones on the way out, zones go last
+    const auto items = std::exchange(m_items, {});
+    for (auto item : items) {
+        item->m_registry = nullptr;
+        delete item;
+    }
+    qDeleteAll(std::exchange(m_zones, {}));
+}
+
+void ZoneRegistry::addZone(ZoneCore *zone)
+{
+    Q_ASSERT(!m_zones.contains(zone->handle()));
+    m_zones.insert(zone->handle(), zone);
+}
+
+void ZoneRegistry::removeZone(const QString &handle)
+{
+    delete m_zones.take(handle);
+}
+
+bool ZoneRegistry::addItem(const QObject *toplevel, ZoneCoreItem *item)
+{
+    Q_ASSERT(!item->m_registry);
+    if (m_items.contains(toplevel)) {
+        return false;
+    }
+    item->m_registry = this;
+    item->m_toplevel = toplevel;
+    m_items.insert(toplevel, item);
+    return true;
+}
+
+void ZoneRegistry::removeToplevel(const QObject *toplevel)
+{
+    if (auto item = m_items.take(toplevel)) {
+        item->m_registry = nullptr;
+        delete item;
+    }
+}
+
+int ZoneRegistry::refreshZones()
+{
+    int events = 0;
+    for (auto zone : std::as_const(m_zones)) {
+        if (zone->hasDirtyItems()) {
+            events += zone->refreshItems();
+        }
+    }
+    return events;
+}
+
+void ZoneRegistry::forgetItem(ZoneCoreItem *item)
+{
+    Q_ASSERT(m_items.value(item->m_toplevel) == item);
+    m_items.remove(item->m_toplevel);
+    item->m_registry = nullptr;
+}
+
+void ZoneBatch::addItem(ZoneCore *zone, ZoneCoreItem *item)
+{
+    m_entries.append({item, item->m_toplevel, zone, zone->handle(), QPoint()});
+}
+
+void ZoneBatch::setPosition(ZoneCoreItem *item, const QPoint &position)
+{
+    m_entries.append({item, item->m_toplevel, nullptr, QString(), position});
+}
+
+int ZoneBatch::commit(const ZoneRegistry &registry)
+{
+    int applied = 0;
+    for (const Entry &entry : std::as_const(m_entries)) {
+        // only compared, the item or zone may be gone
+        if (registry.item(entry.toplevel) != entry.item) {
+            continue;
+        }
+        if (entry.zone) {
+            if (registry.zone(entry.handle) != entry.zone) {
+                continue;
+            }
+            entry.zone->addItem(entry.item);
+        } else {
+            entry.item->setPosition(entry.position);
+        }
+        ++applied;
+    }
+    // keeps the capacity for the next batch
+    m_entries.clear();
+    return applied;
+}
+
+} // namespace KWin
@@ -0,0 +1,323 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMargins>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+
+#include <chrono>
+#include <optional>
+
+#include "zonesmetrics.h"
+
+class QObject;
+
+namespace KWin
+{
+class ZoneBatch;
+class ZoneCore;
+class ZoneRegistry;
+
+/**
+ * An item as the zone bookkeeping sees it.
+ *
+ * It knows nothing about Wayland or KWin: ExtZoneItemV1Interface implements
+ * it for real windows and the autotests implement it with stand-ins.
+ */
+class ZoneCoreItem
+{
+public:
+    /// Reports to @p metrics, if any, counting requests and events for @p client
+    explicit ZoneCoreItem(ZonesMetrics *metrics = nullptr, const QString &client = QString());
+    virtual ~ZoneCoreItem();
+    Q_DISABLE_COPY_MOVE(ZoneCoreItem)
+
+    ZoneCore *zone() const
+    {
+        return m_zone;
+    }
+
+    /**
+     * Inert items have lost their window. They leave their zone, must not
+     * join another one and do not send events anymore.
+     */
+    bool isInert() const
+    {
+        return m_inert;
+    }
+    void makeInert();
+
+    /**
+     * To be called once when the window closes, before it is destroyed: the
+     * item turns inert, lets go of the window and tells its client.
+     */
+    void closeWindow();
+
+    /**
+     * Handles set_position, the position is relative to the item's zone.
+     * @returns false if the request failed, position_failed is sent then
+     */
+    bool setPosition(const QPoint &position);
+
+    /// Items without a window can not be moved
+    virtual bool hasWindow() const
+    {
+        return true;
+    }
+    virtual QRectF frameGeometry() const = 0;
+    virtual QMargins frameMargins() const = 0;
+    virtual void move(const QPoint &position) = 0;
+    virtual void sendFrameExtents(const QMargins &margins) = 0;
+    virtual void sendPosition(const QPoint &position) = 0;
+    virtual void sendPositionFailed() = 0;
+    virtual void sendClosed() = 0;
+
+protected:
+    /// Drops every reference to the window, which is about to be destroyed
+    virtual void releaseWindow()
+    {
+    }
+
+private:
+    friend class ZoneCore;
+    friend class ZoneRegistry;
+    friend class ZoneBatch;
+    ZonesMetrics *const m_metrics;
+    ZonesMetrics::ClientCounters *const m_clientMetrics;
+    // everything else about the item is kept by its zone, at m_slot
+    ZoneCore *m_zone = nullptr;
+    quint32 m_slot = 0;
+    bool m_inert = false;
+    // set while the item is listed in a registry
+    ZoneRegistry *m_registry = nullptr;
+    const QObject *m_toplevel = nullptr;
+};
+
+/**
+ * The state of a zone: its area and the items in it, including what they
+ * sent to their client and which moves are waiting for a commit.
+ *
+ * The per item state is stored as parallel arrays indexed by the item's
+ * slot. Removing an item moves the last one into its slot, so the arrays
+ * stay dense and keep their capacity, and the zone does not allocate for
+ * requests and events on items that are already in it.
+ */
+class ZoneCore
+{
+public:
+    /**
+     * Creates a zone spanning several areas, usually the placement areas of
+     * different outputs. The zone covers their bounding rectangle and each
+     * of them can be updated separately using setPartition().
+     * The zone reports to @p metrics, if any.
+     */
+    ZoneCore(const QList<QRect> &partitions, const QString &handle, ZonesMetrics *metrics = nullptr);
+    virtual ~ZoneCore();
+    Q_DISABLE_COPY_MOVE(ZoneCore)
+
+    QString handle() const
+    {
+        return m_handle;
+    }
+    QRect area() const
+    {
+        return m_area;
+    }
+    void setArea(const QRect &area);
+    void setPartitions(const QList<QRect> &partitions);
+    void setPartition(qsizetype index, const QRect &area);
+
+    /// Moves @p windowRect so it is reachable within the zone
+    void constrainPosition(QRect &windowRect) const;
+
+    const QList<ZoneCoreItem *> &items() const
+    {
+        return m_items;
+    }
+
+    /**
+     * Makes @p item a member of this zone, taking it out of its previous one.
+     * Its frame extents and position are sent on the next refreshItems().
+     * @returns false if the item is inert or already in this zone
+     */
+    bool addItem(ZoneCoreItem *item);
+
+    /// @returns false if @p item is not in this zone
+    bool removeItem(ZoneCoreItem *item);
+
+    /**
+     * Stores @p position, relative to the zone, to be applied on the next
+     * commit of @p item, which must be in this zone. A later request
+     * replaces the one still waiting.
+     */
+    void requestPosition(ZoneCoreItem *item, const QPoint &position);
+    bool hasPendingPosition(const ZoneCoreItem *item) const;
+
+    /**
+     * Moves @p item to its requested position if there is one.
+     * @returns how long the move waited for the commit
+     */
+    std::optional<std::chrono::nanoseconds> applyPendingPosition(ZoneCoreItem *item);
+
+    /**
+     * Makes @p item send its geometry changes to the client on the next
+     * refreshItems(), so that windows changing several times in a row, or all
+     * windows changing at once on a decoration or scale change, only report
+     * their final state.
+     */
+    void markDirty(ZoneCoreItem *item);
+    bool hasDirtyItems() const
+    {
+        return !m_dirtyItems.isEmpty();
+    }
+
+    /**
+     * Sends the frame extents and position of the dirty items if they differ
+     * from what their client was told last.
+     * @returns the number of events sent
+     */
+    int refreshItems();
+
+protected:
+    virtual void itemEntered(ZoneCoreItem *item);
+    virtual void itemLeft(ZoneCoreItem *item);
+    virtual void areaResized();
+
+private:
+    friend class ZoneCoreItem;
+    void detach(ZoneCoreItem *item);
+    void dropDirty(ZoneCoreItem *item);
+    int refreshItem(ZoneCoreItem *item);
+    void updateArea();
+
+    ZonesMetrics *const m_metrics;
+    ZonesMetrics::Counters *const m_counters;
+
+    enum ItemFlag : quint8 {
+        Pending = 1 << 0,
+        ForcePosition = 1 << 1,
+        Dirty = 1 << 2,
+        ForceExtents = 1 << 3,
+    };
+
+    // per item state, indexed by ZoneCoreItem::m_slot
+    QList<ZoneCoreItem *> m_items;
+    QList<quint8> m_flags;
+    QList<QMargins> m_sentMargins;
+    QList<QPoint> m_sentPositions;
+    QList<QPoint> m_pendingPositions;
+    QList<std::chrono::steady_clock::time_point> m_pendingSince;
+    QList<quint32> m_dirtyIndices; // into m_dirtyItems
+
+    QList<ZoneCoreItem *> m_dirtyItems;
+    QList<QRect> m_partitions;
+    QRect m_area;
+    const QString m_handle;
+};
+
+/**
+ * The zones and items of a compositor. Zones are found by their handle and
+ * items by the toplevel they were created for, which has one item at most.
+ *
+ * The registry owns both. Items may still be deleted on their own, when
+ * their resource goes away, and are forgotten then.
+ */
+class ZoneRegistry
+{
+public:
+    ZoneRegistry() = default;
+    ~ZoneRegistry();
+    Q_DISABLE_COPY_MOVE(ZoneRegistry)
+
+    const QHash<QString, ZoneCore *> &zones() const
+    {
+        return m_zones;
+    }
+    ZoneCore *zone(const QString &handle) const
+    {
+        return m_zones.value(handle);
+    }
+
+    /// Takes @p zone, no other zone may have its handle
+    void addZone(ZoneCore *zone);
+
+    /// Deletes the zone of @p handle, like when its output goes away
+    void removeZone(const QString &handle);
+
+    const QHash<const QObject *, ZoneCoreItem *> &items() const
+    {
+        return m_items;
+    }
+    ZoneCoreItem *item(const QObject *toplevel) const
+    {
+        return m_items.value(toplevel);
+    }
+
+    /**
+     * Takes @p item, made for @p toplevel.
+     * @returns false if the toplevel has an item already, @p item is not taken then
+     */
+    bool addItem(const QObject *toplevel, ZoneCoreItem *item);
+
+    /// Deletes the item of @p toplevel, which is being destroyed
+    void removeToplevel(const QObject *toplevel);
+
+    /**
+     * Sends the pending geometry changes of every zone.
+     * @returns the number of events sent
+     */
+    int refreshZones();
+
+private:
+    friend class ZoneCoreItem;
+    void forgetItem(ZoneCoreItem *item);
+
+    QHash<QString, ZoneCore *> m_zones;
+    QHash<const QObject *, ZoneCoreItem *> m_items;
+};
+
+/**
+ * add_item and set_position requests of several items, applied together by
+ * commit(). The items must be in a registry, which tells at commit time
+ * whether they and their zones are still there.
+ */
+class ZoneBatch
+{
+public:
+    void addItem(ZoneCore *zone, ZoneCoreItem *item);
+    void setPosition(ZoneCoreItem *item, const QPoint &position);
+    qsizetype size() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * Applies the requests in the order they were made, skipping those whose
+     * item or zone left @p registry in the meantime, and empties the batch.
+     * Unlike a separate add_item, an item already in its zone is not
+     * confirmed with item_entered.
+     * @returns the number of requests applied
+     */
+    int commit(const ZoneRegistry &registry);
+
+private:
+    struct Entry {
+        ZoneCoreItem *item;
+        const QObject *toplevel;
+        // null for set_position
+        ZoneCore *zone;
+        QString handle;
+        QPoint position;
+    };
+    QList<Entry> m_entries;
+};
+
+} // namespace KWin
@@ -5,7 +5,9 @@
 */
 
 #include "zones.h"
+#include "zonesmetrics.h"
 #include "qwayland-server-xx-zones-v1.h"
+#include "qwayland-server-kde-zones-batch-v1.h"
 
 #include <wayland/clientconnection.h>
 #include <wayland/display.h>
@@ -21,6 +23,9 @@
 #include <KConfig>
 #include <KConfigGroup>
 
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+
 #include <kwinzonescompositorlogging.h>
 
 #ifdef KWIN_ZONES_SUPPORT_VIRTUAL_DESKTOP_STRUTS
@@ -30,28 +35,45 @@
 namespace KWin
 {
 static const int s_version = 1;
+static const int s_batchVersion = 1;
 class ExtZoneV1Interface;
 
-class ExtZoneItemV1Interface : public QObject, public QtWaylandServer::xx_zone_item_v1
+class ExtZoneItemV1Interface : public QObject, public QtWaylandServer::xx_zone_item_v1, public ZoneCoreItem
 {
     Q_OBJECT
 public:
-    explicit ExtZoneItemV1Interface(XdgToplevelInterface *toplevel, struct ::wl_client *client, uint32_t id, int version)
+    explicit ExtZoneItemV1Interface(ZonesMetrics *metrics, XdgToplevelInterface *toplevel, struct ::wl_client *client, uint32_t id, int version)
         : xx_zone_item_v1(client, id, version)
+        , ZoneCoreItem(metrics, waylandServer()->display()->getConnection(client)->executablePath())
         , m_toplevel(toplevel)
+        , m_window(waylandServer()->findWindow(toplevel->surface()))
     {
-        auto w = window();
-        connect(w, &Window::clientGeometryChanged, this, &ExtZoneItemV1Interface::refreshPosition);
-        connect(w, &Window::closed, this, [this] {
-            send_closed();
+        if (!m_window) {
+            qCWarning(KWINZONES) << "Could not find the toplevel's window" << toplevel->title() << toplevel->appId();
+            return;
+        }
+        connect(m_window, &Window::frameGeometryChanged, this, &ExtZoneItemV1Interface::markDirty);
+        connect(m_window, &Window::clientGeometryChanged, this, &ExtZoneItemV1Interface::markDirty);
+        connect(m_window, &Window::closed, this, [this] {
+            closeWindow();
         });
+        // a move waiting in the zone is found through the item's slot, so
+        // one connection made here serves every set_position
+        if (auto s = m_window->surface()) {
+            connect(s, &SurfaceInterface::committed, this, &ExtZoneItemV1Interface::applyPendingPosition);
+        }
     }
-
-    ~ExtZoneItemV1Interface()
+    void xx_zone_item_v1_destroy(Resource *resource) override
     {
-        if (m_zone) {
-            m_zone->m_items.remove(this);
+        if (auto zone = this->zone()) {
+            zone->removeItem(this);
         }
+        wl_resource_destroy(resource->handle);
+    }
+
+    void xx_zone_item_v1_destroy_resource(Resource */*resource*/) override
+    {
+        delete this;
     }
 
     static ExtZoneItemV1Interface *get(::wl_resource *resource)
@@ -60,166 +82,272 @@ public:
     }
 
     Window *window() const {
-        if (!m_toplevel) {
-            return nullptr;
-        }
-        return waylandServer()->findWindow(m_toplevel->surface());
+        return m_window;
     }
 
-    void constrainPosition(QRect &windowRect) const
+    void xx_zone_item_v1_set_position(Resource */*resource*/, int32_t x, int32_t y) override
     {
-        if (windowRect.left() > m_zone->m_area.right()) {
-            windowRect.moveLeft(m_zone->m_area.right() - windowRect.width());
-        }
-        if (windowRect.right() < m_zone->m_area.left()) {
-            windowRect.moveLeft(m_zone->m_area.left());
-        }
-        if (windowRect.top() > m_zone->m_area.bottom()) {
-            windowRect.moveTop(m_zone->m_area.bottom() - windowRect.height());
-        }
-        if (windowRect.bottom() < m_zone->m_area.top()) {
-            windowRect.moveTop(m_zone->m_area.top());
+        if (!setPosition(QPoint(x, y))) {
+            qCDebug(KWINZONES) << "set_position: Could not find surface" << m_toplevel << zone();
         }
     }
 
-    void xx_zone_item_v1_set_position(Resource *resource, int32_t x, int32_t y) override
+    bool hasWindow() const override
+    {
+        return m_window;
+    }
+
+    QRectF frameGeometry() const override
+    {
+        return m_window ? m_window->frameGeometry() : QRectF();
+    }
+
+    QMargins frameMargins() const override
     {
-        auto w = window();
-        if (!w || !m_zone) {
-            qCDebug(KWINZONES) << "set_position: Could not find surface" << m_toplevel << m_zone;
-            send_position_failed(resource->handle);
+        return m_window ? m_window->frameMargins() : QMargins();
+    }
+
+    void move(const QPoint &position) override
+    {
+        if (!m_window) {
             return;
         }
+        static const QString s_objectName = QStringLiteral("kwinzones");
+        if (m_window->objectName() != s_objectName) {
+            m_window->setObjectName(s_objectName);
+        }
+        qCDebug(KWINZONES) << "Setting position. title:" << m_window->caption() << "zone:" << zone()->handle() << "position:" << position << "geometry:" << m_window->frameGeometry();
+        m_window->move(position);
+    }
 
-        QRect windowRect = w->frameGeometry().toRect();
-        windowRect.moveTopLeft(QPoint(x, y));
-        constrainPosition(windowRect);
-        const QPoint pos = windowRect.topLeft();
+    void sendFrameExtents(const QMargins &margins) override
+    {
+        send_frame_extents(margins.top(), margins.bottom(), margins.left(), margins.right());
+    }
 
-        w->setObjectName("kwinzones");
-        if (auto s = w->surface()) {
-            if (m_setPositionDelay) {
-                disconnect(m_setPositionDelay);
-            }
+    void sendPosition(const QPoint &position) override
+    {
+        send_position(position.x(), position.y());
+    }
 
-            m_setPositionDelay = connect(s, &SurfaceInterface::committed, this, [w, pos, handle = m_zone->m_handle] {
-                qCDebug(KWINZONES) << "Setting position. title:" << w->caption() << "zone:" << handle << "position:" << pos << "geometry:" << w->frameGeometry();
-                w->move(pos);
-            }, Qt::SingleShotConnection);
-        }
+    void sendPositionFailed() override
+    {
+        send_position_failed();
     }
 
-    void refreshPosition()
+    void sendClosed() override
     {
-        if (!m_zone) {
-            return;
-        }
-        auto w = window();
-        if (!w) {
-            qCWarning(KWINZONES) << "Could not refresh position, could not find the toplevel's window" << m_toplevel->title() << m_toplevel->appId();
-            return;
+        send_closed();
+    }
+
+protected:
+    void releaseWindow() override
+    {
+        if (auto s = m_window->surface()) {
+            disconnect(s, nullptr, this, nullptr);
         }
-        const QMargins margins = w->frameMargins();
-        if (margins != m_currentMargins) {
-            m_currentMargins = margins;
-            send_frame_extents(margins.top(), margins.bottom(), margins.left(), margins.right());
+        disconnect(m_window, nullptr, this, nullptr);
+        m_window = nullptr;
+    }
+
+private:
+    // Applies the position requested by set_position on the next commit
+    void applyPendingPosition()
+    {
+        if (auto zone = this->zone()) {
+            zone->applyPendingPosition(this);
         }
+    }
 
-        const QPointF pos = w->frameGeometry().topLeft() - m_zone->m_area.topLeft();
-        send_position(pos.x(), pos.y());
+    void markDirty()
+    {
+        if (auto zone = this->zone()) {
+            zone->markDirty(this);
+        }
     }
 
     XdgToplevelInterface *const m_toplevel;
-    ExtZoneV1Interface* m_zone = nullptr;
-    QMargins m_currentMargins;
-    QMetaObject::Connection m_setPositionDelay;
+    // reset when the window closes, closed is emitted before it goes away
+    Window *m_window;
 };
 
+void ExtZoneV1Interface::xx_zone_v1_add_item(Resource* resource, struct ::wl_resource* item)
+{
+    auto w = ExtZoneItemV1Interface::get(item);
+    if (!w || w->isInert())
+    {
+        qCDebug(KWINZONES) << "Skip setting zone" << w << this;
+        return;
+    }
+    if (w->zone() == this)
+    {
+        // item_entered confirms the request even if nothing changes
+        send_item_entered(resource->handle, item);
+        return;
+    }
+    addItem(w);
+}
 
 void ExtZoneV1Interface::xx_zone_v1_remove_item(Resource* resource, struct ::wl_resource* item)
 {
     auto w = ExtZoneItemV1Interface::get(item);
-    if (!w)
+    if (w && w->isInert())
     {
-        qCDebug(KWINZONES) << "Zone Item not found" << item;
         return;
     }
-    w->m_zone = nullptr;
-    send_item_left(resource->handle, item);
-    StackingUpdatesBlocker blocker(workspace());
-    for (auto item : m_items)
+    if (!w || !removeItem(w))
     {
-        workspace()->unconstrain(w->window(), item->window());
-        workspace()->unconstrain(item->window(), w->window());
+        // item_left is due even for items that never were in this zone,
+        // but their actual zone must be left alone
+        qCDebug(KWINZONES) << "Zone Item not found in zone" << item << w << handle();
+        send_item_left(resource->handle, item);
     }
-    m_items.remove(w);
 }
 
-void ExtZoneV1Interface::setArea(const QRect& area)
+void ExtZoneV1Interface::itemEntered(ZoneCoreItem *item)
 {
-    if (m_area == area)
+    auto itemResource = static_cast<ExtZoneItemV1Interface *>(item)->resource();
+    forEachResource(itemResource->client(), [this, itemResource] (Resource *resource) {
+        send_item_entered(resource->handle, itemResource->handle);
+    });
+}
+
+void ExtZoneV1Interface::itemLeft(ZoneCoreItem *item)
+{
+    auto w = static_cast<ExtZoneItemV1Interface *>(item);
+    if (auto itemResource = w->resource())
     {
-        return;
+        forEachResource(itemResource->client(), [this, itemResource] (Resource *resource) {
+            send_item_left(resource->handle, itemResource->handle);
+        });
     }
 
-    const bool sizeChange = m_area.size() != area.size();
-    m_area = area;
-    if (sizeChange)
+    auto window = w->window();
+    if (!window)
     {
-        const auto clientResources = resourceMap();
-        for (auto r : clientResources)
+        return;
+    }
+    StackingUpdatesBlocker blocker(workspace());
+    for (auto other : items())
+    {
+        if (auto otherWindow = static_cast<ExtZoneItemV1Interface *>(other)->window())
         {
-            send_size(r->handle, m_area.width(), m_area.height());
+            workspace()->unconstrain(window, otherWindow);
+            workspace()->unconstrain(otherWindow, window);
         }
     }
 }
 
-void ExtZoneV1Interface::setThisZone(wl_resource* item)
+void ExtZoneV1Interface::areaResized()
 {
-    auto w = ExtZoneItemV1Interface::get(item);
-    if (!w || w->m_zone == this)
+    const auto clientResources = resourceMap();
+    for (auto r : clientResources)
+    {
+        send_size(r->handle, area().width(), area().height());
+    }
+}
+
+class KdeZoneBatchV1Interface : public QtWaylandServer::kde_zone_batch_v1
+{
+public:
+    KdeZoneBatchV1Interface(ZoneRegistry *registry, struct ::wl_client *client, uint32_t id, int version)
+        : kde_zone_batch_v1(client, id, version)
+        , m_registry(registry)
     {
-        qCDebug(KWINZONES) << "Skip setting zone" << w << this;
-        return;
     }
-    if (w->m_zone && w->m_zone != this)
+
+    void kde_zone_batch_v1_destroy(Resource *resource) override
     {
-        for (auto resource : w->m_zone->resourceMap())
-        {
-            if (resource->client() == item->client)
-            {
-                w->m_zone->send_item_left(resource->handle, item);
-            }
+        wl_resource_destroy(resource->handle);
+    }
+
+    void kde_zone_batch_v1_destroy_resource(Resource */*resource*/) override
+    {
+        delete this;
+    }
+
+    void kde_zone_batch_v1_add_item(Resource */*resource*/, struct ::wl_resource *zone, struct ::wl_resource *item) override
+    {
+        auto z = resource_cast<ExtZoneV1Interface *>(zone);
+        auto w = ExtZoneItemV1Interface::get(item);
+        if (z && w) {
+            m_batch.addItem(z, w);
         }
     }
-    w->m_zone = this;
-    m_items.insert(w);
-    for (auto resource : resourceMap())
+
+    void kde_zone_batch_v1_set_position(Resource */*resource*/, struct ::wl_resource *item, int32_t x, int32_t y) override
     {
-        if (resource->client() == item->client)
+        if (auto w = ExtZoneItemV1Interface::get(item)) {
+            m_batch.setPosition(w, QPoint(x, y));
+        }
+    }
+
+    void kde_zone_batch_v1_commit(Resource *resource) override
+    {
+        qCDebug(KWINZONES) << "Applying a batch of" << m_batch.size() << "requests";
+        int applied = 0;
         {
-            w->m_zone->send_item_entered(resource->handle, item);
+            StackingUpdatesBlocker blocker(workspace());
+            applied = m_batch.commit(*m_registry);
         }
+        // frame_extents and position follow with the next sweep, in the
+        // same flush as long as nothing else wakes the compositor first
+        send_done(resource->handle, applied);
     }
 
-    auto window = w->window();
-    if (window)
+private:
+    ZoneRegistry *const m_registry;
+    ZoneBatch m_batch;
+};
+
+class KdeZoneBatchManagerV1Interface : public QtWaylandServer::kde_zone_batch_manager_v1
+{
+public:
+    KdeZoneBatchManagerV1Interface(Display *display, ZoneRegistry *registry)
+        : kde_zone_batch_manager_v1(*display, s_batchVersion)
+        , m_registry(registry)
     {
-        w->m_currentMargins = window->frameMargins();
-        w->send_frame_extents(w->m_currentMargins.top(), w->m_currentMargins.bottom(), w->m_currentMargins.left(), w->m_currentMargins.right());
+    }
 
-        const QPointF pos = window->frameGeometry().topLeft() - m_area.topLeft();
-        w->send_position(pos.x(), pos.y());
+    void kde_zone_batch_manager_v1_destroy(Resource *resource) override
+    {
+        wl_resource_destroy(resource->handle);
+    }
+
+    void kde_zone_batch_manager_v1_get_batch(Resource *resource, uint32_t id) override
+    {
+        new KdeZoneBatchV1Interface(m_registry, resource->client(), id, resource->version());
     }
-}
+
+private:
+    ZoneRegistry *const m_registry;
+};
 
 class ExtZoneManagerV1Interface : public QObject, public QtWaylandServer::xx_zone_manager_v1
 {
 public:
-    ExtZoneManagerV1Interface(Display *display, QObject *parent)
+    ExtZoneManagerV1Interface(Display *display, ZonesMetrics *metrics, QObject *parent)
         : QObject(parent)
         , xx_zone_manager_v1(*display, s_version)
+        , m_display(display)
+        , m_metrics(metrics)
+        , m_batches(display, &m_registry)
     {
+        // Geometry changes are sent once the compositor is done with what
+        // woke it up, so a change touching every window is a single sweep.
+        connect(QCoreApplication::eventDispatcher(), &QAbstractEventDispatcher::aboutToBlock, this, &ExtZoneManagerV1Interface::refreshZones);
+    }
+
+    void refreshZones()
+    {
+        if (m_registry.refreshZones() > 0) {
+            m_display->flush();
+        }
+    }
+
+    ExtZoneV1Interface *zone(const QString &handle) const
+    {
+        return static_cast<ExtZoneV1Interface *>(m_registry.zone(handle));
     }
 
     void xx_zone_manager_v1_destroy(Resource *resource) override {
@@ -234,15 +362,14 @@ public:
             return;
         }
 
-        auto it = m_zoneWindows.constFind(toplevel);
-        if (it != m_zoneWindows.constEnd()) {
+        if (m_registry.item(toplevel)) {
             wl_resource_post_error(resource->handle, QtWaylandServer::xx_zone_v1::error_invalid, "zone item already created");
             return;
         }
-        auto zoneWindow = new ExtZoneItemV1Interface(toplevel, resource->client(), id, s_version);
-        m_zoneWindows.insert(toplevel,  zoneWindow);
-        connect(toplevel, &XdgToplevelInterface::aboutToBeDestroyed, this, [this, toplevel] {
-            delete m_zoneWindows.take(toplevel);
+        auto zoneWindow = new ExtZoneItemV1Interface(m_metrics, toplevel, resource->client(), id, s_version);
+        m_registry.addItem(toplevel, zoneWindow);
+        connect(toplevel, &XdgToplevelInterface::aboutToBeDestroyed, zoneWindow, [this, toplevel] {
+            m_registry.removeToplevel(toplevel);
         });
     }
 
@@ -267,59 +394,148 @@ public:
 
         auto output = outputIface->handle();
         const auto handle = output->name();
-        auto it = m_zones.constFind(handle);
-        if (it == m_zones.constEnd()) {
-#if KWIN_ZONES_SUPPORT_VIRTUAL_DESKTOP_STRUTS
-            const QRectF geometry = workspace()->clientArea(PlacementArea, output, VirtualDesktopManager::self()->currentDesktop());
-            auto zone = new ExtZoneV1Interface(geometry.toRect(), handle);
+        auto zone = this->zone(handle);
+        if (!zone) {
+            zone = new ExtZoneV1Interface(placementArea(output), handle, m_metrics);
             connect(output, &LogicalOutput::geometryChanged, zone, [zone, output] {
-                const QRectF geometry = workspace()->clientArea(PlacementArea, output, VirtualDesktopManager::self()->currentDesktop());
-                zone->setArea(geometry.toRect());
+                zone->setArea(placementArea(output));
             });
-#else
-            const QRectF geometry = workspace()->clientArea(PlacementArea, output);
-            auto zone = new ExtZoneV1Interface(geometry.toRect(), handle);
-            connect(output, &LogicalOutput::geometryChanged, zone, [zone, output] {
-                const QRectF geometry = workspace()->clientArea(PlacementArea, output);
-                zone->setArea(geometry.toRect());
-            });
-#endif
-            connect(workspace(), &Workspace::outputRemoved, this, [this, handle] (LogicalOutput *output) {
+            connect(workspace(), &Workspace::outputRemoved, zone, [this, handle] (LogicalOutput *output) {
                 if (handle == output->name())
-                    delete m_zones.take(output->name());
+                    m_registry.removeZone(handle);
             });
-            it = m_zones.insert(handle, zone);
+            m_registry.addZone(zone);
         }
-        (*it)->add(resource->client(), id, s_version);
+        zone->add(resource->client(), id, s_version);
     }
 
 
     void xx_zone_manager_v1_get_zone_from_handle(Resource *resource, uint32_t id, const QString & handle) override
     {
-        auto it = m_zones.constFind(handle);
+        auto zone = this->zone(handle);
         static const KSharedConfig::Ptr cfgZones = KSharedConfig::openConfig("kwinzonesrc");
-        if (it == m_zones.constEnd()) {
-            KConfigGroup grp = cfgZones->group("Zones");
+        if (!zone) {
             static auto watcher = KConfigWatcher::create(cfgZones);
-            auto zone = new ExtZoneV1Interface(grp.readEntry(handle, QRect()), handle);
-            connect(watcher.get(), &KConfigWatcher::configChanged, zone, [handle, zone] (const KConfigGroup &group, const QByteArrayList &names) {
-                if (!names.contains(handle)) {
-                    return;
-                }
-                zone->setArea(group.readEntry(handle, QRect()));
+            const QStringList outputNames = cfgZones->group("CompositeZones").readEntry(handle, QStringList());
+            if (!outputNames.isEmpty()) {
+                zone = createCompositeZone(handle, outputNames);
+                connect(watcher.get(), &KConfigWatcher::configChanged, zone, [handle, zone] (const KConfigGroup &group, const QByteArrayList &names) {
+                    if (group.name() != QLatin1String("CompositeZones") || !names.contains(handle)) {
+                        return;
+                    }
+                    trackCompositeOutputs(zone, group.readEntry(handle, QStringList()));
+                });
+            } else {
+                KConfigGroup grp = cfgZones->group("Zones");
+                zone = new ExtZoneV1Interface(grp.readEntry(handle, QRect()), handle, m_metrics);
+                connect(watcher.get(), &KConfigWatcher::configChanged, zone, [handle, zone] (const KConfigGroup &group, const QByteArrayList &names) {
+                    if (group.name() != QLatin1String("Zones") || !names.contains(handle)) {
+                        return;
+                    }
+                    zone->setArea(group.readEntry(handle, QRect()));
+                });
+            }
+            m_registry.addZone(zone);
+        }
+        zone->add(resource->client(), id, s_version);
+    }
+
+    static QRect placementArea(LogicalOutput *output)
+    {
+#if KWIN_ZONES_SUPPORT_VIRTUAL_DESKTOP_STRUTS
+        return workspace()->clientArea(PlacementArea, output, VirtualDesktopManager::self()->currentDesktop()).toRect();
+#else
+        return workspace()->clientArea(PlacementArea, output).toRect();
+#endif
+    }
+
+    /**
+     * Creates a zone that spans the placement areas of all @p outputNames.
+     * Every output gets its own partition so that a change on one output only
+     * updates its part of the zone. Outputs may come and go at any time.
+     */
+    ExtZoneV1Interface *createCompositeZone(const QString &handle, const QStringList &outputNames)
+    {
+        auto zone = new ExtZoneV1Interface(compositePartitions(outputNames), handle, m_metrics);
+        trackCompositeOutputs(zone, outputNames);
+        qCDebug(KWINZONES) << "Created composite zone" << handle << "spanning" << outputNames;
+        return zone;
+    }
+
+    /// The placement areas of @p outputNames, empty for outputs that are not connected
+    static QList<QRect> compositePartitions(const QStringList &outputNames)
+    {
+        QList<QRect> partitions(std::max<qsizetype>(outputNames.size(), 1));
+        const auto outputs = workspace()->outputs();
+        for (LogicalOutput *output : outputs) {
+            const qsizetype index = outputNames.indexOf(output->name());
+            if (index >= 0) {
+                partitions[index] = placementArea(output);
+            }
+        }
+        return partitions;
+    }
+
+    /**
+     * Makes the partitions of @p zone follow @p outputNames, replacing the
+     * outputs it followed so far. The new partitions are applied at once so
+     * clients only see the final size.
+     */
+    static void trackCompositeOutputs(ExtZoneV1Interface *zone, const QStringList &outputNames)
+    {
+        // The connections live in their own context so a configuration
+        // change can drop them all at once.
+        static const QString s_trackerName = QStringLiteral("kwinzones-output-tracker");
+        delete zone->findChild<QObject *>(s_trackerName, Qt::FindDirectChildrenOnly);
+        auto tracker = new QObject(zone);
+        tracker->setObjectName(s_trackerName);
+
+        zone->setPartitions(compositePartitions(outputNames));
+        auto followOutput = [zone, tracker, outputNames] (LogicalOutput *output) {
+            const qsizetype index = outputNames.indexOf(output->name());
+            if (index < 0) {
+                return false;
+            }
+            connect(output, &LogicalOutput::geometryChanged, tracker, [zone, index, output] {
+                zone->setPartition(index, placementArea(output));
             });
-            it = m_zones.insert(handle, zone);
+            return true;
+        };
+
+        const auto outputs = workspace()->outputs();
+        for (LogicalOutput *output : outputs) {
+            followOutput(output);
         }
-        (*it)->add(resource->client(), id, s_version);
+        connect(workspace(), &Workspace::outputAdded, tracker, [zone, outputNames, followOutput] (LogicalOutput *output) {
+            if (followOutput(output)) {
+                zone->setPartition(outputNames.indexOf(output->name()), placementArea(output));
+            }
+        });
+        connect(workspace(), &Workspace::outputRemoved, tracker, [zone, outputNames] (LogicalOutput *output) {
+            const qsizetype index = outputNames.indexOf(output->name());
+            if (index >= 0) {
+                zone->setPartition(index, QRect());
+            }
+        });
     }
 
-    QHash<QString, ExtZoneV1Interface *> m_zones;
-    QHash<XdgToplevelInterface *, ExtZoneItemV1Interface *> m_zoneWindows;
+    Display *const m_display;
+    ZonesMetrics *const m_metrics;
+    ZoneRegistry m_registry;
+    // goes away before the registry its batches use
+    KdeZoneBatchManagerV1Interface m_batches;
 };
 
 Zones::Zones()
-    : m_extZones(new ExtZoneManagerV1Interface(waylandServer()->display(), this))
+    : m_metrics(new ZonesMetrics(QDBusConnection::sessionBus(), this))
+    , m_extZones(new ExtZoneManagerV1Interface(waylandServer()->display(), m_metrics, this))
+{
+}
+
+Zones::~Zones()
 {
+    // zones and items report to the metrics until they are gone
+    delete m_extZones;
 }
 
 }
@@ -7,10 +7,11 @@
 #pragma once
 
 #include <QRect>
-#include <QSet>
 
 #include <plugin.h>
 #include "qwayland-server-xx-zones-v1.h"
+#include "zonecore.h"
+#include "zonesmetrics.h"
 
 namespace KWin
 {
@@ -22,29 +23,34 @@ class Zones : public Plugin
     Q_OBJECT
 public:
     explicit Zones();
+    ~Zones() override;
 
 private:
+    ZonesMetrics *const m_metrics;
     ExtZoneManagerV1Interface *const m_extZones;
 };
 
-class ExtZoneV1Interface : public QObject, public QtWaylandServer::xx_zone_v1
+class ExtZoneV1Interface : public QObject, public QtWaylandServer::xx_zone_v1, public ZoneCore
 {
     Q_OBJECT
 
 public:
-    ExtZoneV1Interface(const QRect& area, const QString& handle)
-        : m_area(area)
-          , m_handle(handle)
+    ExtZoneV1Interface(const QRect& area, const QString& handle, ZonesMetrics* metrics)
+        : ExtZoneV1Interface(QList<QRect>{area}, handle, metrics)
+    {
+    }
+
+    ExtZoneV1Interface(const QList<QRect>& partitions, const QString& handle, ZonesMetrics* metrics)
+        : ZoneCore(partitions, handle, metrics)
     {
-        Q_ASSERT(!m_handle.isEmpty());
         setObjectName(handle);
     }
 
     void xx_zone_v1_bind_resource(Resource* resource) override
     {
-        const QSizeF size = m_area.size();
+        const QSizeF size = area().size();
         send_size(resource->handle, size.width(), size.height());
-        send_handle(resource->handle, m_handle);
+        send_handle(resource->handle, handle());
         send_done(resource->handle);
     }
 
@@ -53,22 +59,25 @@ public:
         wl_resource_destroy(resource->handle);
     }
 
-    void xx_zone_v1_add_item(Resource*/*resource*/, struct ::wl_resource* item) override
-    {
-        setThisZone(item);
-    }
-
+    void xx_zone_v1_add_item(Resource* resource, struct ::wl_resource* item) override;
     void xx_zone_v1_remove_item(Resource* resource, struct ::wl_resource* item) override;
 
-    void setArea(const QRect& area);
+protected:
+    void itemEntered(ZoneCoreItem *item) override;
+    void itemLeft(ZoneCoreItem *item) override;
+    void areaResized() override;
 
 private:
-    void setThisZone(wl_resource* item);
-
-    friend class ExtZoneItemV1Interface;
-    QSet<ExtZoneItemV1Interface*> m_items;
-    QRect m_area;
-    const QString m_handle;
+    /// Calls @p func for the zone resources bound by @p client only
+    template<typename Func>
+    void forEachResource(wl_client *client, Func func)
+    {
+        const auto resources = resourceMap();
+        for (auto [it, end] = resources.equal_range(client); it != end; ++it)
+        {
+            func(*it);
+        }
+    }
 };
 
 } // namespace KWin
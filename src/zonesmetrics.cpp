@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "zonesmetrics.h"
+
+#include <QDBusError>
+
+#include <kwinzonescompositorlogging.h>
+
+namespace KWin
+{
+static const QString s_metricsPath = QStringLiteral("/Zones");
+
+void ZonesMetrics::Counters::addPendingWait(std::chrono::nanoseconds wait)
+{
+    ++movesApplied;
+    pendingWaitTotal += wait;
+    pendingWaitMax = std::max(pendingWaitMax, wait);
+}
+
+QVariantMap ZonesMetrics::Counters::toVariantMap() const
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    return {
+        {QStringLiteral("positionEvents"), positionEvents},
+        {QStringLiteral("setPositionRequests"), setPositionRequests},
+        {QStringLiteral("movesApplied"), movesApplied},
+        {QStringLiteral("pendingWaitTotalUs"), qint64(duration_cast<microseconds>(pendingWaitTotal).count())},
+        {QStringLiteral("pendingWaitMaxUs"), qint64(duration_cast<microseconds>(pendingWaitMax).count())},
+    };
+}
+
+QVariantMap ZonesMetrics::ClientCounters::toVariantMap() const
+{
+    QVariantMap map = Counters::toVariantMap();
+    map.insert(QStringLiteral("positionFailed"), positionFailed);
+    return map;
+}
+
+ZonesMetrics::ZonesMetrics(const QDBusConnection &bus, QObject *parent)
+    : QObject(parent)
+    , m_bus(bus)
+{
+    if (m_bus.isConnected() && !m_bus.registerObject(s_metricsPath, this, QDBusConnection::ExportScriptableSlots)) {
+        qCWarning(KWINZONES) << "Could not register the zones metrics on D-Bus" << m_bus.lastError().message();
+    }
+}
+
+ZonesMetrics::~ZonesMetrics()
+{
+    m_bus.unregisterObject(s_metricsPath);
+}
+
+ZonesMetrics::Counters *ZonesMetrics::zone(const QString &handle)
+{
+    return &m_zones[handle];
+}
+
+ZonesMetrics::ClientCounters *ZonesMetrics::client(const QString &executable)
+{
+    return &m_clients[executable];
+}
+
+QVariantMap ZonesMetrics::snapshot() const
+{
+    QVariantMap zones;
+    for (const auto &[handle, counters] : m_zones) {
+        zones.insert(handle, counters.toVariantMap());
+    }
+    QVariantMap clients;
+    for (const auto &[executable, counters] : m_clients) {
+        clients.insert(executable, counters.toVariantMap());
+    }
+    return {
+        {QStringLiteral("zonesAlive"), zonesAlive},
+        {QStringLiteral("itemsAlive"), itemsAlive},
+        {QStringLiteral("zones"), zones},
+        {QStringLiteral("clients"), clients},
+    };
+}
+
+void ZonesMetrics::reset()
+{
+    for (auto &[handle, counters] : m_zones) {
+        counters = {};
+    }
+    for (auto &[executable, counters] : m_clients) {
+        counters = {};
+    }
+}
+
+} // namespace KWin
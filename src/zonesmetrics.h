@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 Aleix Pol Gonzalez <aleix.pol_gonzalez@mercedes-benz.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QDBusConnection>
+#include <QObject>
+#include <QVariantMap>
+
+#include <chrono>
+#include <map>
+
+namespace KWin
+{
+
+/**
+ * Keeps track of how much work the zones are doing and exposes it on D-Bus
+ * at /Zones as org.kde.KWin.Zones.Metrics.
+ *
+ * Counters are kept per zone handle and per client executable. Zones and
+ * items keep a pointer to their counters so updating them is just an
+ * increment; entries are never removed, reset() only zeroes them.
+ * Everything happens on the compositor thread so no atomics are needed.
+ *
+ * Zones and items are given the metrics they report to, they work without.
+ */
+class ZonesMetrics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.KWin.Zones.Metrics")
+public:
+    struct Counters
+    {
+        quint64 positionEvents = 0;
+        quint64 setPositionRequests = 0;
+        quint64 movesApplied = 0;
+        std::chrono::nanoseconds pendingWaitTotal = {};
+        std::chrono::nanoseconds pendingWaitMax = {};
+
+        void addPendingWait(std::chrono::nanoseconds wait);
+        QVariantMap toVariantMap() const;
+    };
+
+    /**
+     * A set_position that fails never reaches a zone, so only clients count
+     * failures. A client's setPositionRequests include its positionFailed.
+     */
+    struct ClientCounters : Counters
+    {
+        quint64 positionFailed = 0;
+
+        QVariantMap toVariantMap() const;
+    };
+
+    explicit ZonesMetrics(const QDBusConnection &bus = QDBusConnection::sessionBus(), QObject *parent = nullptr);
+    ~ZonesMetrics() override;
+
+    Counters *zone(const QString &handle);
+    ClientCounters *client(const QString &executable);
+
+    int zonesAlive = 0;
+    int itemsAlive = 0;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QVariantMap snapshot() const;
+    Q_SCRIPTABLE void reset();
+
+private:
+    QDBusConnection m_bus;
+    std::map<QString, Counters> m_zones;
+    std::map<QString, ClientCounters> m_clients;
+};
+
+} // namespace KWin